@@ -11,24 +11,42 @@
 #pragma once
 
 #include "kdalgorithms_bits/cartesian_product.h"
+#include "kdalgorithms_bits/chunked.h"
+#include "kdalgorithms_bits/compact.h"
+#include "kdalgorithms_bits/contiguous_search.h"
+#include "kdalgorithms_bits/enumerate.h"
+#include "kdalgorithms_bits/eytzinger.h"
 #include "kdalgorithms_bits/filter.h"
 #include "kdalgorithms_bits/find_if.h"
 #include "kdalgorithms_bits/generate.h"
+#include "kdalgorithms_bits/group_adjacent.h"
 #include "kdalgorithms_bits/insert_wrapper.h"
 #include "kdalgorithms_bits/invoke.h"
+#include "kdalgorithms_bits/join.h"
+#include "kdalgorithms_bits/merge.h"
 #include "kdalgorithms_bits/method_tests.h"
 #include "kdalgorithms_bits/operators.h"
+#include "kdalgorithms_bits/parallel.h"
 #include "kdalgorithms_bits/read_iterator_wrapper.h"
 #include "kdalgorithms_bits/reserve_helper.h"
 #include "kdalgorithms_bits/return_type_trait.h"
+#include "kdalgorithms_bits/scan.h"
+#include "kdalgorithms_bits/select.h"
+#include "kdalgorithms_bits/set_algebra.h"
 #include "kdalgorithms_bits/shared.h"
+#include "kdalgorithms_bits/sink.h"
+#include "kdalgorithms_bits/static_set.h"
+#include "kdalgorithms_bits/subrange.h"
 #include "kdalgorithms_bits/to_function_object.h"
 #include "kdalgorithms_bits/transform.h"
+#include "kdalgorithms_bits/unzip.h"
 #include "kdalgorithms_bits/zip.h"
 #include <algorithm>
 #include <map>
 #include <numeric>
+#include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -51,6 +69,10 @@ void copy(InputContainer &&input, OutputContainer &output)
         copy(tmp, output);
         return;
     }
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        copy(detail::shared_input<InputContainer>(input), output);
+        return;
+    }
     auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
     std::copy(range.begin(), range.end(), detail::insert_wrapper(output));
 }
@@ -132,15 +154,25 @@ Container sorted(Container container, Compare &&compare = {})
 
 enum sort_direction { ascending, descending };
 
+namespace detail {
+    // Compares two items by the value that member extracts from them. Used by the *_by
+    // algorithms, which sort, merge or pick the smallest items.
+    template <typename Member>
+    auto compare_by(Member member, sort_direction direction)
+    {
+        return [member = std::move(member), direction](const auto &x, const auto &y) {
+            if (direction == ascending)
+                return detail::invoke(member, x) < detail::invoke(member, y);
+            else
+                return detail::invoke(member, x) > detail::invoke(member, y);
+        };
+    }
+} // namespace detail
+
 template <typename Container, typename Member>
 void sort_by(Container &container, Member member, sort_direction direction = ascending)
 {
-    sort(container, [member, direction](const auto &x, const auto &y) {
-        if (direction == ascending)
-            return detail::invoke(member, x) < detail::invoke(member, y);
-        else
-            return detail::invoke(member, x) > detail::invoke(member, y);
-    });
+    sort(container, detail::compare_by(member, direction));
 }
 
 template <typename Container, typename Member>
@@ -150,6 +182,13 @@ auto sorted_by(Container container, Member member, sort_direction direction = as
     return container;
 }
 
+// -------------------- merged_by --------------------
+template <typename Containers, typename Member>
+auto merged_by(Containers &&containers, Member member, sort_direction direction = ascending)
+{
+    return merged(std::forward<Containers>(containers), detail::compare_by(member, direction));
+}
+
 // -------------------- is_sorted --------------------
 template <typename Container, typename Compare = std::less<ValueType<Container>>>
 bool is_sorted(const Container &container, Compare &&compare = {})
@@ -159,14 +198,92 @@ bool is_sorted(const Container &container, Compare &&compare = {})
 }
 
 // -------------------- contains / value_in --------------------
+namespace detail {
+    // Associative containers offer a lookup which is a lot faster than a linear search.
+    // QMap and QHash are not included, as iterating those yields the mapped values only.
+    // Containers of integers stored in contiguous memory use the kernels from
+    // contiguous_search.h rather than std::find and std::count. Sets and maps with a custom
+    // comparator are searched linearly, as their lookup may find items which aren't equal.
+    struct linear_lookup
+    {
+    };
+    struct node_lookup
+    {
+    };
+    struct contiguous_lookup
+    {
+    };
+    struct set_lookup
+    {
+    };
+    struct map_lookup
+    {
+    };
+
+    template <typename Container, typename Value>
+    using sequence_lookup_kind =
+        std::conditional_t<use_contiguous_search_v<Container, Value>, contiguous_lookup,
+                           linear_lookup>;
+
+    template <typename Container, typename Value>
+    using lookup_kind = std::conditional_t<
+        !has_key_type_v<Container> || has_keyValueBegin_v<Container>,
+        sequence_lookup_kind<Container, Value>,
+        std::conditional_t<
+            !has_default_lookup<Container>::value, node_lookup,
+            std::conditional_t<
+                has_mapped_type_v<Container>,
+                std::conditional_t<has_equal_range_on_key_v<Container, Value>, map_lookup,
+                                   linear_lookup>,
+                std::conditional_t<has_find_v<Container, Value>, set_lookup, linear_lookup>>>>;
+
+    template <typename Container, typename Value>
+    bool contains(const Container &container, Value &&value, linear_lookup)
+    {
+        return std::find(std::cbegin(container), std::cend(container), std::forward<Value>(value))
+            != std::cend(container);
+    }
+
+    template <typename Container, typename Value>
+    bool contains(const Container &container, Value &&value, contiguous_lookup)
+    {
+        return contiguous_contains(container, value);
+    }
+
+    template <typename Container, typename Value>
+    bool contains(const Container &container, Value &&value, node_lookup)
+    {
+        return contains(container, std::forward<Value>(value), linear_lookup());
+    }
+
+    template <typename Container, typename Value>
+    bool contains(const Container &container, Value &&value, set_lookup)
+    {
+        return is_valid_key<Container>(value)
+            && container.find(std::forward<Value>(value)) != container.end();
+    }
+
+    // The keys in the range are all equivalent to value.first, so only the mapped values are left
+    // to compare.
+    template <typename Container, typename Value>
+    bool contains(const Container &container, Value &&value, map_lookup)
+    {
+        if (!is_valid_key<Container>(value.first))
+            return false;
+        auto range = container.equal_range(value.first);
+        return std::any_of(range.first, range.second,
+                           [&value](const auto &item) { return item.second == value.second; });
+    }
+}
+
 template <typename Container, typename Value>
 #if __cplusplus >= 202002L
     requires std::equality_comparable_with<ValueType<Container>, Value>
 #endif
 bool contains(const Container &container, Value &&value)
 {
-    return std::find(std::cbegin(container), std::cend(container), std::forward<Value>(value))
-        != std::cend(container);
+    return detail::contains(container, std::forward<Value>(value),
+                            detail::lookup_kind<Container, Value>());
 }
 
 template <typename Value, typename ContainerValue>
@@ -189,14 +306,79 @@ bool value_in(Value &&value, std::initializer_list<ContainerValue> container)
     return contains(container, std::forward<Value>(value));
 }
 
+template <typename Value, typename ContainerValue, std::size_t N>
+#if __cplusplus >= 202002L
+    requires std::equality_comparable_with<ContainerValue, Value>
+#endif
+constexpr bool value_in(Value &&value, const static_set<ContainerValue, N> &container)
+{
+    return container.contains(value);
+}
+
 // -------------------- count / count_if --------------------
+namespace detail {
+    template <typename Container, typename Value>
+    int count(const Container &container, Value &&value, linear_lookup)
+    {
+        return std::count(std::cbegin(container), std::cend(container),
+                          std::forward<Value>(value));
+    }
+
+    template <typename Container, typename Value>
+    int count(const Container &container, Value &&value, contiguous_lookup)
+    {
+        return contiguous_count(container, value);
+    }
+
+    template <typename Container, typename Value>
+    int count(const Container &container, Value &&value, node_lookup)
+    {
+        return count(container, std::forward<Value>(value), linear_lookup());
+    }
+
+    template <typename Container, typename Value>
+    int count_in_set(const Container &container, const Value &value,
+                     std::true_type /*has_equal_range*/)
+    {
+        auto range = container.equal_range(value);
+        return std::distance(range.first, range.second);
+    }
+
+    // QSet doesn't offer equal_range, but on the other hand, it can't have duplicates.
+    template <typename Container, typename Value>
+    int count_in_set(const Container &container, const Value &value,
+                     std::false_type /*has_equal_range*/)
+    {
+        return container.find(value) != container.end() ? 1 : 0;
+    }
+
+    template <typename Container, typename Value>
+    int count(const Container &container, Value &&value, set_lookup)
+    {
+        if (!is_valid_key<Container>(value))
+            return 0;
+        return count_in_set(container, value, has_equal_range<Container, Value>());
+    }
+
+    template <typename Container, typename Value>
+    int count(const Container &container, Value &&value, map_lookup)
+    {
+        if (!is_valid_key<Container>(value.first))
+            return 0;
+        auto range = container.equal_range(value.first);
+        return std::count_if(range.first, range.second,
+                             [&value](const auto &item) { return item.second == value.second; });
+    }
+}
+
 template <typename Container, typename Value>
 #if __cplusplus >= 202002L
     requires ContainerOfType<Container, Value>
 #endif
 int count(const Container &container, Value &&value)
 {
-    return std::count(std::cbegin(container), std::cend(container), std::forward<Value>(value));
+    return detail::count(container, std::forward<Value>(value),
+                         detail::lookup_kind<Container, Value>());
 }
 
 template <typename Container, typename UnaryPredicate>
@@ -210,6 +392,46 @@ int count_if(const Container &container, UnaryPredicate &&predicate)
                          detail::to_function_object(std::forward<UnaryPredicate>(predicate)));
 }
 
+// -------------------- sorted_contains / sorted_count / sorted_index_of --------------------
+// Versions of contains, count and index_of_match for containers which are known to be sorted
+// according to compare, which uses binary search rather than a linear search.
+template <typename Container, typename Value, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+    && ContainerOfType<Container, Value>
+#endif
+bool sorted_contains(const Container &container, Value &&value, Compare &&compare = {})
+{
+    auto _compare = detail::to_function_object(std::forward<Compare>(compare));
+    auto it = std::lower_bound(std::cbegin(container), std::cend(container), value, _compare);
+    return it != std::cend(container) && !_compare(value, *it);
+}
+
+template <typename Container, typename Value, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+    && ContainerOfType<Container, Value>
+#endif
+int sorted_count(const Container &container, Value &&value, Compare &&compare = {})
+{
+    auto range = std::equal_range(std::cbegin(container), std::cend(container), value,
+                                  detail::to_function_object(std::forward<Compare>(compare)));
+    return std::distance(range.first, range.second);
+}
+
+template <typename Container, typename Value, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+    && ContainerOfType<Container, Value>
+#endif
+auto sorted_index_of(const Container &container, Value &&value, Compare &&compare = {})
+{
+    auto _compare = detail::to_function_object(std::forward<Compare>(compare));
+    auto it = std::lower_bound(std::cbegin(container), std::cend(container), value, _compare);
+    const bool found = it != std::cend(container) && !_compare(value, *it);
+    return found ? std::distance(std::cbegin(container), it) : -1;
+}
+
 // -------------------- min_value / max_value --------------------
 #if __cplusplus >= 201703L
 template <typename Container, typename Compare = std::less<ValueType<Container>>>
@@ -252,6 +474,154 @@ min_element(const Container &container, Compare &&compare = {})
 }
 #endif
 
+// -------------------- minmax_value / minmax_by --------------------
+template <typename T>
+struct minmax_result
+{
+    T min;
+    T max;
+};
+
+#if __cplusplus >= 201703L
+namespace detail {
+    template <typename Container, typename Compare>
+    constexpr bool is_plain_integral_compare_v = std::is_integral<ValueType<Container>>::value
+        && (std::is_same<remove_cvref_t<Compare>, std::less<ValueType<Container>>>::value
+            || std::is_same<remove_cvref_t<Compare>, std::less<>>::value);
+
+    template <typename Container, typename Compare>
+    auto minmax_value_helper(const Container &container, Compare &&compare, std::false_type)
+    {
+        auto [min, max] = std::minmax_element(std::cbegin(container), std::cend(container),
+                                              std::forward<Compare>(compare));
+        return minmax_result<ValueType<Container>>{*min, *max};
+    }
+
+    // For integral values there is no need to keep track of positions, and a plain
+    // reduction like the one below is turned into SIMD code by the compiler.
+    template <typename Container, typename Compare>
+    auto minmax_value_helper(const Container &container, Compare && /*compare*/, std::true_type)
+    {
+        auto it = std::cbegin(container);
+        const auto end = std::cend(container);
+        ValueType<Container> min = *it;
+        ValueType<Container> max = *it;
+        for (++it; it != end; ++it) {
+            const ValueType<Container> value = *it;
+            min = value < min ? value : min;
+            max = max < value ? value : max;
+        }
+        return minmax_result<ValueType<Container>>{min, max};
+    }
+}
+
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+#endif
+std::optional<minmax_result<ValueType<Container>>> minmax_value(const Container &container,
+                                                                Compare &&compare = {})
+{
+    if (std::cbegin(container) == std::cend(container))
+        return {};
+
+    return detail::minmax_value_helper(
+        container, detail::to_function_object(std::forward<Compare>(compare)),
+        std::integral_constant<bool, detail::is_plain_integral_compare_v<Container, Compare>>());
+}
+#endif
+
+template <typename Container, typename Projection>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Projection, ValueType<Container>>
+#endif
+auto minmax_by(Container &&container, Projection projection)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "minmax_by refers into the container, so it can't be used with temporaries");
+
+    auto range = detail::find_if_iterator_wrapper(container);
+    auto result = std::minmax_element(range.begin(), range.end(),
+                                      detail::compare_by(std::move(projection), ascending));
+
+    using Iterator = decltype(range.begin());
+    return minmax_result<iterator_result<Iterator>>{
+        {result.first, range.begin(), range.end()}, {result.second, range.begin(), range.end()}};
+}
+
+// -------------------- min_index / max_index --------------------
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+#endif
+auto min_index(const Container &container, Compare &&compare = {})
+{
+    auto it = std::min_element(std::cbegin(container), std::cend(container),
+                               detail::to_function_object(std::forward<Compare>(compare)));
+    return it != std::cend(container) ? std::distance(std::cbegin(container), it) : -1;
+}
+
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+#endif
+auto max_index(const Container &container, Compare &&compare = {})
+{
+    auto it = std::max_element(std::cbegin(container), std::cend(container),
+                               detail::to_function_object(std::forward<Compare>(compare)));
+    return it != std::cend(container) ? std::distance(std::cbegin(container), it) : -1;
+}
+
+// -------------------- min_ref / max_ref / min_by / max_by --------------------
+// Like find_if, these return a proxy referring to the item rather than a copy of it.
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+#endif
+auto min_ref(Container &&container, Compare &&compare = {})
+{
+    auto range = detail::find_if_iterator_wrapper(container);
+    auto it = std::min_element(range.begin(), range.end(),
+                               detail::to_function_object(std::forward<Compare>(compare)));
+    using Iterator = decltype(range.begin());
+    return detail::create_result<Iterator>(std::move(it), range.begin(), range.end(),
+                                           std::is_lvalue_reference<Container>());
+}
+
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<Compare, Container>
+#endif
+auto max_ref(Container &&container, Compare &&compare = {})
+{
+    auto range = detail::find_if_iterator_wrapper(container);
+    auto it = std::max_element(range.begin(), range.end(),
+                               detail::to_function_object(std::forward<Compare>(compare)));
+    using Iterator = decltype(range.begin());
+    return detail::create_result<Iterator>(std::move(it), range.begin(), range.end(),
+                                           std::is_lvalue_reference<Container>());
+}
+
+template <typename Container, typename Projection>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Projection, ValueType<Container>>
+#endif
+auto min_by(Container &&container, Projection projection)
+{
+    return min_ref(std::forward<Container>(container),
+                   detail::compare_by(std::move(projection), ascending));
+}
+
+template <typename Container, typename Projection>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Projection, ValueType<Container>>
+#endif
+auto max_by(Container &&container, Projection projection)
+{
+    return max_ref(std::forward<Container>(container),
+                   detail::compare_by(std::move(projection), ascending));
+}
+
 // -------------------- max_value_less_than / min_value_greater_than --------------------
 #if __cplusplus >= 201703L
 template <typename Container, typename Item, typename Compare = std::less<ValueType<Container>>>
@@ -333,6 +703,111 @@ std::optional<Item> min_value_greater_than_unordered(const Container &container,
 #endif
 
 // -------------------- is_permutation --------------------
+namespace detail {
+    struct std_permutation
+    {
+    };
+    struct hash_permutation
+    {
+    };
+    struct sort_permutation
+    {
+    };
+
+    // Below this size, std::is_permutation is faster than building a hash table or sorting.
+    constexpr std::size_t permutation_search_threshold = 64;
+
+    // The faster algorithms are only used when comparing with operator==, as that
+    // is what std::hash and operator< must be consistent with.
+    template <typename Container1, typename Container2, typename Compare>
+    constexpr bool is_default_equal_v =
+        std::is_same<ValueType<Container1>, ValueType<Container2>>::value
+        && (std::is_same<remove_cvref_t<Compare>, std::equal_to<ValueType<Container1>>>::value
+            || std::is_same<remove_cvref_t<Compare>, std::equal_to<>>::value);
+
+    // The faster algorithms refer to the items by pointer, which isn't possible for containers
+    // like std::vector<bool>, whose iterators return proxies rather than references.
+    template <typename Container>
+    using has_item_references =
+        std::is_lvalue_reference<decltype(*std::cbegin(std::declval<const Container &>()))>;
+
+    template <typename Container1, typename Container2, typename Compare>
+    using permutation_kind = std::conditional_t<
+        !is_default_equal_v<Container1, Container2, Compare>
+            || !has_item_references<Container1>::value
+            || !has_item_references<Container2>::value,
+        std_permutation,
+        std::conditional_t<has_std_hash_v<ValueType<Container1>>, hash_permutation,
+                           std::conditional_t<has_operator_lt_v<ValueType<Container1>>,
+                                              sort_permutation, std_permutation>>>;
+
+    template <typename Iterator1, typename Iterator2, typename Compare>
+    bool is_permutation(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                        Compare &&compare, std_permutation)
+    {
+        return std::is_permutation(first1, last1, first2, last2, std::forward<Compare>(compare));
+    }
+
+    // Counts the items of the first range, and subtracts the items of the second range.
+    template <typename Iterator1, typename Iterator2, typename Compare>
+    bool is_permutation(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                        Compare &&, hash_permutation)
+    {
+        using T = remove_cvref_t<decltype(*first1)>;
+        auto hash = [](const T *item) { return std::hash<T>()(*item); };
+        auto equal = [](const T *x, const T *y) { return *x == *y; };
+        std::unordered_map<const T *, std::size_t, decltype(hash), decltype(equal)> counts(
+            static_cast<std::size_t>(std::distance(first1, last1)), hash, equal);
+
+        for (; first1 != last1; ++first1)
+            ++counts[std::addressof(*first1)];
+
+        for (; first2 != last2; ++first2) {
+            auto it = counts.find(std::addressof(*first2));
+            if (it == counts.end() || it->second == 0)
+                return false;
+            --it->second;
+        }
+        return true;
+    }
+
+    template <typename Iterator1, typename Iterator2, typename Compare>
+    bool is_permutation(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                        Compare &&, sort_permutation)
+    {
+        using T = remove_cvref_t<decltype(*first1)>;
+        auto sortedPointers = [](auto first, auto last) {
+            std::vector<const T *> result;
+            result.reserve(static_cast<std::size_t>(std::distance(first, last)));
+            for (; first != last; ++first)
+                result.push_back(std::addressof(*first));
+            std::sort(result.begin(), result.end(),
+                      [](const T *x, const T *y) { return *x < *y; });
+            return result;
+        };
+
+        // operator< may order by only part of what operator== compares, so each run of
+        // equivalent items is compared with std::is_permutation.
+        auto less = [](const T *x, const T *y) { return *x < *y; };
+        auto equal = [](const T *x, const T *y) { return *x == *y; };
+        const auto items1 = sortedPointers(first1, last1);
+        const auto items2 = sortedPointers(first2, last2);
+        auto it2 = items2.cbegin();
+        for (auto it1 = items1.cbegin(); it1 != items1.cend();) {
+            if (less(*it1, *it2) || less(*it2, *it1))
+                return false;
+            const auto runEnd1 = std::upper_bound(it1, items1.cend(), *it1, less);
+            const auto runEnd2 = std::upper_bound(it2, items2.cend(), *it1, less);
+            if (runEnd1 - it1 != runEnd2 - it2
+                || !std::is_permutation(it1, runEnd1, it2, runEnd2, equal))
+                return false;
+            it1 = runEnd1;
+            it2 = runEnd2;
+        }
+        return true;
+    }
+} // namespace detail
+
 template <typename Container1, typename Container2,
           typename Compare = std::equal_to<ValueType<Container1>>>
 #if __cplusplus >= 202002L
@@ -342,9 +817,22 @@ template <typename Container1, typename Container2,
 bool is_permutation(const Container1 &container1, const Container2 &container2,
                     Compare &&compare = {})
 {
-    return std::is_permutation(std::cbegin(container1), std::cend(container1),
-                               std::cbegin(container2), std::cend(container2),
-                               detail::to_function_object(std::forward<Compare>(compare)));
+    auto first1 = std::cbegin(container1);
+    auto last1 = std::cend(container1);
+    auto first2 = std::cbegin(container2);
+    auto last2 = std::cend(container2);
+    if (std::distance(first1, last1) != std::distance(first2, last2))
+        return false;
+
+    // Skip the common prefix, which is cheap, and often most of the containers
+    auto function = detail::to_function_object(std::forward<Compare>(compare));
+    std::tie(first1, first2) = std::mismatch(first1, last1, first2, last2, function);
+    if (static_cast<std::size_t>(std::distance(first1, last1))
+        < detail::permutation_search_threshold)
+        return std::is_permutation(first1, last1, first2, last2, function);
+
+    return detail::is_permutation(first1, last1, first2, last2, function,
+                                  detail::permutation_kind<Container1, Container2, Compare>());
 }
 
 // -------------------- accumulate --------------------
@@ -528,6 +1016,81 @@ namespace detail {
         return count;
     }
 
+    template <typename Container, typename Value>
+    auto erase(Container &container, Value &&value, contiguous_lookup)
+    {
+        return erase(container, std::forward<Value>(value), linear_lookup());
+    }
+
+    template <typename Container, typename Value>
+    auto erase(Container &container, Value &&value, linear_lookup)
+    {
+#if __cplusplus >= 202002L
+        using std::erase;
+        if constexpr (requires { erase(container, std::forward<Value>(value)); }) {
+            return erase(container, std::forward<Value>(value));
+        } else {
+            return detail::erase_fallback(container, std::forward<Value>(value));
+        }
+#else
+        return detail::erase_fallback(container, std::forward<Value>(value));
+#endif
+    }
+
+    template <typename Container, typename Value>
+    auto erase_from_set(Container &container, Value &&value, std::false_type /*has_remove*/)
+    {
+        return container.erase(std::forward<Value>(value));
+    }
+
+    // QSet
+    template <typename Container, typename Value>
+    auto erase_from_set(Container &container, Value &&value, std::true_type /*has_remove*/)
+    {
+        return container.remove(std::forward<Value>(value)) ? 1 : 0;
+    }
+
+    template <typename Container, typename Value>
+    auto erase(Container &container, Value &&value, set_lookup)
+    {
+        return is_valid_key<Container>(value)
+            ? erase_from_set(container, std::forward<Value>(value), has_remove<Container, Value>())
+            : 0;
+    }
+
+    template <typename Container, typename Value>
+    auto erase(Container &container, Value &&value, node_lookup)
+    {
+        typename Container::size_type count = 0;
+        for (auto it = container.begin(); it != container.end();) {
+            if (*it == value) {
+                it = container.erase(it);
+                ++count;
+            } else {
+                ++it;
+            }
+        }
+        return count;
+    }
+
+    template <typename Container, typename Value>
+    auto erase(Container &container, Value &&value, map_lookup)
+    {
+        typename Container::size_type count = 0;
+        if (!is_valid_key<Container>(value.first))
+            return count;
+        auto range = container.equal_range(value.first);
+        for (auto it = range.first; it != range.second;) {
+            if (it->second == value.second) {
+                it = container.erase(it);
+                ++count;
+            } else {
+                ++it;
+            }
+        }
+        return count;
+    }
+
 } // namespace detail
 
 template <typename Container, typename Value>
@@ -536,16 +1099,8 @@ template <typename Container, typename Value>
 #endif
 auto erase(Container &container, Value &&value)
 {
-#if __cplusplus >= 202002L
-    using std::erase;
-    if constexpr (requires { erase(container, std::forward<Value>(value)); }) {
-        return erase(container, std::forward<Value>(value));
-    } else {
-        return detail::erase_fallback(container, std::forward<Value>(value));
-    }
-#else
-    return detail::erase_fallback(container, std::forward<Value>(value));
-#endif
+    return detail::erase(container, std::forward<Value>(value),
+                         detail::lookup_kind<Container, Value>());
 }
 
 template <typename Container, typename UnaryPredicate>
@@ -571,6 +1126,40 @@ auto erase_if(Container &container, UnaryPredicate &&predicate)
         container, detail::to_function_object(std::forward<UnaryPredicate>(predicate)));
 #endif
 }
+
+namespace detail {
+    template <typename Container, typename UnaryPredicate>
+    auto erase_if(Container &container, UnaryPredicate &&predicate, CompactOption /*option*/,
+                  std::false_type /*can compact branchless*/)
+    {
+        return kdalgorithms::erase_if(container, std::forward<UnaryPredicate>(predicate));
+    }
+
+    template <typename Container, typename UnaryPredicate>
+    auto erase_if(Container &container, UnaryPredicate &&predicate, CompactOption option,
+                  std::true_type /*can compact branchless*/)
+    {
+        using Count = decltype(kdalgorithms::erase_if(container, predicate));
+        if (option == compact_branching)
+            return kdalgorithms::erase_if(container, std::forward<UnaryPredicate>(predicate));
+        return static_cast<Count>(compact_in_place(
+            container, [&predicate](const auto &item) { return !predicate(item); }));
+    }
+} // namespace detail
+
+// With compact_branchless, contiguous containers of trivially copyable items are compacted
+// without branching on the predicate, see compact.h.
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+auto erase_if(Container &container, UnaryPredicate &&predicate, CompactOption option)
+{
+    return detail::erase_if(container,
+                            detail::to_function_object(std::forward<UnaryPredicate>(predicate)),
+                            option, detail::can_compact_branchless<Container>());
+}
+
 // -------------------- index_of_match --------------------
 template <typename Container, typename UnaryPredicate>
 auto index_of_match(const Container &container, UnaryPredicate &&predicate)
@@ -646,6 +1235,68 @@ auto partitioned(Container &&container, UnaryPredicate predicate)
 }
 
 // -------------------- multi_partitioned --------------------
+namespace detail {
+    template <typename Map, typename Key>
+    bool same_key(const Map &map, const typename Map::key_type &x, const Key &y,
+                  std::true_type /*has_key_comp*/)
+    {
+        return !map.key_comp()(x, y) && !map.key_comp()(y, x);
+    }
+
+    template <typename Map, typename Key>
+    bool same_key(const Map &map, const typename Map::key_type &x, const Key &y,
+                  std::false_type /*has_key_comp*/)
+    {
+        return map.key_eq()(x, y);
+    }
+
+    // Finds the partition of a key in the result of multi_partitioned, creating it if needed.
+    // The std maps don't invalidate references when inserting, so for them the previous partition
+    // is remembered, which saves the lookup for runs of items with the same key, e.g. sorted input.
+    template <typename Map>
+    class partition_finder
+    {
+        using Partition = typename Map::mapped_type;
+        using RemembersPrevious =
+            std::integral_constant<bool, has_key_comp<Map>::value || has_key_eq<Map>::value>;
+
+    public:
+        explicit partition_finder(Map &map)
+            : m_map(map)
+            , m_previous(map.end())
+        {
+        }
+
+        template <typename Key>
+        Partition &operator()(Key &&key)
+        {
+            return find(std::forward<Key>(key), RemembersPrevious());
+        }
+
+    private:
+        template <typename Key>
+        Partition &find(Key &&key, std::true_type /*remembers previous*/)
+        {
+            if (m_previous == m_map.end()
+                || !same_key(m_map, m_previous->first, key, has_key_comp<Map>())) {
+                m_previous =
+                    m_map.insert(typename Map::value_type(std::forward<Key>(key), Partition()))
+                        .first;
+            }
+            return m_previous->second;
+        }
+
+        template <typename Key>
+        Partition &find(Key &&key, std::false_type /*remembers previous*/)
+        {
+            return m_map[std::forward<Key>(key)];
+        }
+
+        Map &m_map;
+        typename Map::iterator m_previous;
+    };
+}
+
 #if __cplusplus >= 202002L
 namespace detail {
     template <typename ResultContainer, typename InputContainer, typename KeyFunction>
@@ -666,9 +1317,13 @@ template <typename ResultContainer, typename InputContainer, typename KeyFunctio
     && detail::KeyFunctionMapsContainerValueToMapKey<ResultContainer, InputContainer, KeyFunction>
     && detail::InputValueCanConvertToResultContainerValue<ResultContainer, InputContainer>
 #endif
-auto multi_partitioned(InputContainer &&container, KeyFunction keyFunction)
+ResultContainer multi_partitioned(InputContainer &&container, KeyFunction keyFunction)
 {
+    if (detail::is_shared_rvalue<InputContainer>(container))
+        return multi_partitioned<ResultContainer>(
+            detail::shared_input<InputContainer>(container), std::move(keyFunction));
     ResultContainer result;
+    detail::partition_finder<ResultContainer> partition(result);
     auto iterators = read_iterator_wrapper(std::forward<InputContainer>(container));
     for (auto it = iterators.begin(); it != iterators.end(); ++it) {
         // Originally the code below simply gave *it to `invoke`:
@@ -681,7 +1336,7 @@ auto multi_partitioned(InputContainer &&container, KeyFunction keyFunction)
         // what is pushed to `result` would be a default constructed value
         // This is tested in multi_partitioned_with_function_taking_a_value
         const auto &cvalue = *it;
-        result[detail::invoke(keyFunction, cvalue)].push_back(*it);
+        partition(detail::invoke(keyFunction, cvalue)).push_back(*it);
     }
     return result;
 }
@@ -709,6 +1364,30 @@ auto multi_partitioned(InputContainer &&container, KeyFunction keyFunction)
                                        std::forward<KeyFunction>(keyFunction));
 }
 
+// Hands each item together with its key, as std::pair<Key, Item>, to sink (see to_sink), rather
+// than collecting the partitions in a map.
+template <typename InputContainer, typename KeyFunction, typename Sink>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<KeyFunction, ValueType<InputContainer>>
+#endif
+void multi_partitioned(InputContainer &&container, KeyFunction keyFunction,
+                       detail::sink_iterator<Sink> sink)
+{
+    if (detail::is_shared_rvalue<InputContainer>(container)) {
+        multi_partitioned(detail::shared_input<InputContainer>(container), std::move(keyFunction),
+                          std::move(sink));
+        return;
+    }
+    auto iterators = read_iterator_wrapper(std::forward<InputContainer>(container));
+    for (auto it = iterators.begin(); it != iterators.end(); ++it) {
+        // See the comment in multi_partitioned above
+        const auto &cvalue = *it;
+        auto key = detail::invoke(keyFunction, cvalue);
+        *sink = std::make_pair(std::move(key), *it);
+        ++sink;
+    }
+}
+
 template <typename Container, typename UnaryFunction>
 #if __cplusplus >= 202002L
     requires UnaryFunctionOnContainerValues<UnaryFunction, Container>
@@ -718,6 +1397,10 @@ template <typename Container, typename UnaryFunction>
 
 void for_each(Container &&container, UnaryFunction &&function)
 {
+    if (detail::is_shared_rvalue<Container>(container)) {
+        for_each(detail::shared_input<Container>(container), std::forward<UnaryFunction>(function));
+        return;
+    }
     auto range = read_iterator_wrapper(std::forward<Container>(container));
     std::for_each(range.begin(), range.end(),
                   detail::to_function_object(std::forward<UnaryFunction>(function)));
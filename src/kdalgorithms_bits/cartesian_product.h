@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "sink.h"
 #include "transform.h"
 #include "tuple_utils.h"
 #include <tuple>
@@ -40,6 +41,21 @@ namespace detail {
         }
         return result;
     }
+
+    template <typename OutputIterator, typename Prefix>
+    void cartesian_product_into(OutputIterator &out, Prefix &&prefix)
+    {
+        *out = std::forward<Prefix>(prefix);
+        ++out;
+    }
+
+    template <typename OutputIterator, typename Prefix, typename Container, typename... REST>
+    void cartesian_product_into(OutputIterator &out, const Prefix &prefix,
+                                const Container &container, const REST &...rest)
+    {
+        for (const auto &item : container)
+            cartesian_product_into(out, std::tuple_cat(prefix, std::make_tuple(item)), rest...);
+    }
 } // namespace detail
 
 template <template <typename...> class ResultContainerClass = std::vector, typename... ARGS>
@@ -48,4 +64,11 @@ auto cartesian_product(ARGS... args)
     return detail::cartesian_product<ResultContainerClass>(std::forward<ARGS>(args)...);
 }
 
+// Hands the tuples to sink (see to_sink) one by one, so the product is never stored.
+template <typename Sink, typename... Containers>
+void cartesian_product(detail::sink_iterator<Sink> sink, const Containers &...containers)
+{
+    detail::cartesian_product_into(sink, std::tuple<>(), containers...);
+}
+
 } // namespace kdalgorithms
@@ -0,0 +1,298 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "read_iterator_wrapper.h"
+#include "shared.h"
+#include "subrange.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace kdalgorithms {
+namespace detail {
+    // A random access iterator for views, which compute their items from an index using at().
+    // Like container iterators, the iterators of all the views in this library, including those
+    // that don't use view_iterator, refer to their view, so they are invalidated when the view is
+    // copied or moved.
+    template <typename View>
+    class view_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using reference = decltype(std::declval<const View &>().at(0));
+        using value_type = typename View::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+
+        view_iterator() = default;
+        view_iterator(const View *view, difference_type index)
+            : m_view(view)
+            , m_index(index)
+        {
+        }
+
+        reference operator*() const { return m_view->at(m_index); }
+        reference operator[](difference_type offset) const { return m_view->at(m_index + offset); }
+
+        view_iterator &operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+        view_iterator operator++(int)
+        {
+            auto result = *this;
+            ++m_index;
+            return result;
+        }
+        view_iterator &operator--()
+        {
+            --m_index;
+            return *this;
+        }
+        view_iterator operator--(int)
+        {
+            auto result = *this;
+            --m_index;
+            return result;
+        }
+        view_iterator &operator+=(difference_type offset)
+        {
+            m_index += offset;
+            return *this;
+        }
+        view_iterator &operator-=(difference_type offset)
+        {
+            m_index -= offset;
+            return *this;
+        }
+
+        friend view_iterator operator+(view_iterator it, difference_type offset)
+        {
+            return it += offset;
+        }
+        friend view_iterator operator+(difference_type offset, view_iterator it)
+        {
+            return it += offset;
+        }
+        friend view_iterator operator-(view_iterator it, difference_type offset)
+        {
+            return it -= offset;
+        }
+        friend difference_type operator-(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index - y.m_index;
+        }
+
+        friend bool operator==(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index == y.m_index;
+        }
+        friend bool operator!=(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index != y.m_index;
+        }
+        friend bool operator<(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index < y.m_index;
+        }
+        friend bool operator>(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index > y.m_index;
+        }
+        friend bool operator<=(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index <= y.m_index;
+        }
+        friend bool operator>=(const view_iterator &x, const view_iterator &y)
+        {
+            return x.m_index >= y.m_index;
+        }
+
+    private:
+        const View *m_view = nullptr;
+        difference_type m_index = 0;
+    };
+
+    // Common part of the views below, which all index into a random access range. Derived
+    // classes provide at(index) and the number of items.
+    template <typename Derived, typename Iterator>
+    class indexed_view
+    {
+        using Category = typename std::iterator_traits<Iterator>::iterator_category;
+        static_assert(std::is_base_of<std::random_access_iterator_tag, Category>::value,
+                      "The views require a container with random access iterators");
+
+    public:
+        using iterator = view_iterator<Derived>;
+        using const_iterator = iterator;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        indexed_view(Iterator begin, Iterator end, difference_type count)
+            : m_begin(std::move(begin))
+            , m_size(std::distance(m_begin, end))
+            , m_count(count)
+        {
+        }
+
+        iterator begin() const { return {static_cast<const Derived *>(this), 0}; }
+        iterator end() const { return {static_cast<const Derived *>(this), m_count}; }
+        size_type size() const { return static_cast<size_type>(m_count); }
+        bool empty() const { return m_count == 0; }
+        decltype(auto) operator[](difference_type index) const
+        {
+            return static_cast<const Derived *>(this)->at(index);
+        }
+
+    protected:
+        Iterator m_begin;
+        difference_type m_size;
+        difference_type m_count;
+    };
+
+    template <typename Iterator>
+    class chunk_view : public indexed_view<chunk_view<Iterator>, Iterator>
+    {
+        using Base = indexed_view<chunk_view<Iterator>, Iterator>;
+
+    public:
+        using value_type = subrange<Iterator>;
+        using typename Base::difference_type;
+
+        chunk_view(Iterator begin, Iterator end, difference_type chunkSize)
+            : Base(begin, end,
+                   chunkSize == 0 ? 0 : (std::distance(begin, end) + chunkSize - 1) / chunkSize)
+            , m_chunkSize(chunkSize)
+        {
+        }
+
+        value_type at(difference_type index) const
+        {
+            auto first = index * m_chunkSize;
+            auto last = std::min(first + m_chunkSize, this->m_size);
+            return {this->m_begin + first, this->m_begin + last};
+        }
+
+    private:
+        difference_type m_chunkSize;
+    };
+
+    template <typename Iterator>
+    class window_view : public indexed_view<window_view<Iterator>, Iterator>
+    {
+        using Base = indexed_view<window_view<Iterator>, Iterator>;
+
+    public:
+        using value_type = subrange<Iterator>;
+        using typename Base::difference_type;
+
+        window_view(Iterator begin, Iterator end, difference_type windowSize)
+            : Base(begin, end,
+                   windowSize == 0
+                       ? 0
+                       : std::max<difference_type>(std::distance(begin, end) - windowSize + 1, 0))
+            , m_windowSize(windowSize)
+        {
+        }
+
+        value_type at(difference_type index) const
+        {
+            return {this->m_begin + index, this->m_begin + index + m_windowSize};
+        }
+
+    private:
+        difference_type m_windowSize;
+    };
+
+    template <typename Iterator>
+    class stride_view : public indexed_view<stride_view<Iterator>, Iterator>
+    {
+        using Base = indexed_view<stride_view<Iterator>, Iterator>;
+
+    public:
+        using value_type = typename std::iterator_traits<Iterator>::value_type;
+        using typename Base::difference_type;
+
+        stride_view(Iterator begin, Iterator end, difference_type stride)
+            : Base(begin, end, stride == 0 ? 0 : (std::distance(begin, end) + stride - 1) / stride)
+            , m_stride(stride)
+        {
+        }
+
+        typename std::iterator_traits<Iterator>::reference at(difference_type index) const
+        {
+            return this->m_begin[index * m_stride];
+        }
+
+    private:
+        difference_type m_stride;
+    };
+
+    template <typename Iterator>
+    struct is_view<chunk_view<Iterator>> : std::true_type
+    {
+    };
+
+    template <typename Iterator>
+    struct is_view<window_view<Iterator>> : std::true_type
+    {
+    };
+
+    template <typename Iterator>
+    struct is_view<stride_view<Iterator>> : std::true_type
+    {
+    };
+
+    // A size of zero gives an empty view.
+    template <template <typename> class View, typename Container>
+    auto make_indexed_view(Container &container, std::size_t n)
+    {
+        using Iterator = decltype(std::begin(container));
+        return View<Iterator>(std::begin(container), std::end(container),
+                              static_cast<std::ptrdiff_t>(n));
+    }
+} // namespace detail
+
+// -------------------- chunked / windowed / strided --------------------
+// Views on a random access container, which don't copy any items. As they refer into the
+// container, they can't be used with temporaries.
+
+// Splits the container into subranges of chunkSize items; the last one may be shorter.
+template <typename Container>
+auto chunked(Container &&container, std::size_t chunkSize)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "chunked refers into the container, so it can't be used with temporaries");
+    return detail::make_indexed_view<detail::chunk_view>(container, chunkSize);
+}
+
+// All subranges of windowSize consecutive items, each one starting one item after the previous.
+template <typename Container>
+auto windowed(Container &&container, std::size_t windowSize)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "windowed refers into the container, so it can't be used with temporaries");
+    return detail::make_indexed_view<detail::window_view>(container, windowSize);
+}
+
+// Every stride'th item of the container, starting with the first one.
+template <typename Container>
+auto strided(Container &&container, std::size_t stride)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "strided refers into the container, so it can't be used with temporaries");
+    return detail::make_indexed_view<detail::stride_view>(container, stride);
+}
+
+} // namespace kdalgorithms
@@ -0,0 +1,68 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "method_tests.h"
+#include "shared.h"
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+// Branchless compaction used by filter, filtered and erase_if for containers of trivially
+// copyable items stored in contiguous memory. Every item is written to the output, which is
+// only advanced when the item is kept, so there is no branch on the outcome of the predicate to
+// mispredict. This pays off for predicates that are hard to predict, i.e. when around half the
+// items are kept, while std::remove_if is better when nearly all or nearly no items are kept.
+// The loop stays scalar: compilers don't vectorize it, as out advances by a data dependent amount.
+
+namespace kdalgorithms {
+
+// How filter, filtered and erase_if collect the kept items. compact_branchless only applies to
+// contiguous containers of trivially copyable items, for other containers it is ignored.
+enum CompactOption { compact_branching, compact_branchless };
+
+namespace detail {
+    template <typename Container>
+    using can_compact_branchless =
+        std::integral_constant<bool,
+                               is_contiguous_v<Container>
+                                   && std::is_trivially_copyable<ValueType<Container>>::value>;
+
+    // Copies the items of [first, last) that keep returns true for to out, and returns the end of
+    // the output. out may be equal to first, but must not point into the rest of the input.
+    template <typename T, typename Keep>
+    T *compact_branchless(const T *first, const T *last, T *out, Keep &keep)
+    {
+        for (; first != last; ++first) {
+            const T item = *first;
+            *out = item;
+            out += static_cast<bool>(keep(item));
+        }
+        return out;
+    }
+
+    // Removes the items keep returns false for, and returns the number of removed items.
+    template <typename Container, typename Keep>
+    auto compact_in_place(Container &container, Keep &&keep)
+    {
+        auto kept = std::begin(container);
+        if (kept != std::end(container)) {
+            // Not data(), which is const for std::string before C++17
+            auto *data = std::addressof(*kept);
+            kept += compact_branchless(data, data + container.size(), data, keep) - data;
+        }
+        auto count = std::distance(kept, std::end(container));
+        container.erase(kept, std::end(container));
+        return count;
+    }
+} // namespace detail
+
+} // namespace kdalgorithms
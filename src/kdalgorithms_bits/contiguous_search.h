@@ -0,0 +1,200 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "method_tests.h"
+#include "shared.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <type_traits>
+
+// Search kernels used by contains and count for containers of integers stored in contiguous
+// memory. The byte sized version uses memchr, which the C library implements using SIMD
+// instructions, selected at runtime for the CPU at hand, and similar for wmemchr. 16 bit items
+// are searched in blocks, which the compiler vectorizes. Counting is done over plain pointers
+// without branches, which the compiler vectorizes as well.
+//
+// QChar is a UTF-16 code unit, so containers of QChar, like QString, are searched as char16_t.
+// See tests/bench_contiguous_search.cpp for a comparison with std::find and std::count.
+
+namespace kdalgorithms {
+namespace detail {
+    // QChar, recognized by its unicode() method, without depending on Qt
+    template <typename T>
+    using is_qchar = std::integral_constant<
+        bool,
+        is_detected_v<tests::has_unicode, remove_cvref_t<T>> && sizeof(remove_cvref_t<T>) == 2
+            && std::is_trivially_copyable<remove_cvref_t<T>>::value>;
+
+    template <typename T>
+    using search_item_t = std::conditional_t<is_qchar<T>::value, char16_t, T>;
+
+    template <typename Container, typename Value>
+    constexpr bool use_contiguous_search_v = is_contiguous_v<Container>
+        && ((std::is_integral<ValueType<Container>>::value
+             && !std::is_same<ValueType<Container>, bool>::value
+             && std::is_integral<remove_cvref_t<Value>>::value)
+            || (is_qchar<ValueType<Container>>::value
+                && std::is_same<ValueType<Container>, remove_cvref_t<Value>>::value));
+
+    template <typename Value>
+    const Value &search_value(const Value &value, std::false_type /*is_qchar*/)
+    {
+        return value;
+    }
+
+    template <typename Value>
+    auto search_value(const Value &value, std::true_type /*is_qchar*/)
+    {
+        return value.unicode();
+    }
+
+    template <typename Container>
+    const search_item_t<ValueType<Container>> *search_data(const Container &container)
+    {
+        return reinterpret_cast<const search_item_t<ValueType<Container>> *>(container.data());
+    }
+
+    // Convert value to the item type of the container. Returns false if the value can't be
+    // represented in that type, in which case no item can compare equal to it.
+    template <typename T, typename Value>
+    constexpr bool to_needle(const Value &value, T &needle)
+    {
+        needle = static_cast<T>(value);
+        return static_cast<Value>(needle) == value;
+    }
+
+    // find converts its argument to the key type, so e.g. a std::set<int> would find 3.5 as 3.
+    // Such keys are first checked to be representable in the key type.
+    template <typename Container, typename Key>
+    using is_converted_arithmetic_key = std::integral_constant<
+        bool,
+        std::is_arithmetic<typename Container::key_type>::value
+            && std::is_arithmetic<remove_cvref_t<Key>>::value
+            && !std::is_same<typename Container::key_type, remove_cvref_t<Key>>::value
+            && !has_transparent_lookup<Container>::value>;
+
+    template <typename Container, typename Key>
+    constexpr bool is_valid_key(const Key & /*key*/,
+                                std::false_type /*is_converted_arithmetic_key*/)
+    {
+        return true;
+    }
+
+    template <typename Container, typename Key>
+    constexpr bool is_valid_key(const Key &key, std::true_type /*is_converted_arithmetic_key*/)
+    {
+        typename Container::key_type converted{};
+        return to_needle(key, converted);
+    }
+
+    template <typename Container, typename Key>
+    constexpr bool is_valid_key(const Key &key)
+    {
+        return is_valid_key<Container>(key, is_converted_arithmetic_key<Container, Key>());
+    }
+
+    template <typename T>
+    const T *find_value(const T *first, const T *last, T value, std::true_type /*byte sized*/)
+    {
+        const void *result = std::memchr(first, static_cast<unsigned char>(value),
+                                         static_cast<std::size_t>(last - first));
+        return result ? static_cast<const T *>(result) : last;
+    }
+
+    inline const wchar_t *find_value(const wchar_t *first, const wchar_t *last, wchar_t value,
+                                     std::false_type /*byte sized*/)
+    {
+        const wchar_t *result = std::wmemchr(first, value, static_cast<std::size_t>(last - first));
+        return result ? result : last;
+    }
+
+    // There is no C library function for 16 bit items (except wchar_t on Windows). Without an
+    // early exit inside a block, the compiler vectorizes the comparisons of the block.
+    template <typename T>
+    const T *find_value_wide(const T *first, const T *last, T value, std::true_type /*16 bit*/)
+    {
+        constexpr std::ptrdiff_t blockSize = 64;
+        while (last - first >= blockSize) {
+            unsigned found = 0;
+            for (std::ptrdiff_t i = 0; i < blockSize; ++i)
+                found |= first[i] == value;
+            if (found)
+                break;
+            first += blockSize;
+        }
+        return std::find(first, last, value);
+    }
+
+    // For wider items the blocked loop isn't faster than the unrolled std::find.
+    template <typename T>
+    const T *find_value_wide(const T *first, const T *last, T value, std::false_type /*16 bit*/)
+    {
+        return std::find(first, last, value);
+    }
+
+    template <typename T>
+    const T *find_value(const T *first, const T *last, T value, std::false_type /*byte sized*/)
+    {
+        return find_value_wide(first, last, value, std::integral_constant<bool, sizeof(T) == 2>());
+    }
+
+    template <typename T>
+    const T *find_value(const T *first, const T *last, T value)
+    {
+        return find_value(first, last, value, std::integral_constant<bool, sizeof(T) == 1>());
+    }
+
+    // The matches of a block are summed in a counter as narrow as the items, so that the
+    // compiler vectorizes the comparisons without having to widen them to std::size_t.
+    template <typename T>
+    std::size_t count_value(const T *first, const T *last, T value)
+    {
+        using Counter = std::conditional_t<(sizeof(T) < sizeof(unsigned)), std::make_unsigned_t<T>,
+                                           unsigned>;
+        constexpr std::ptrdiff_t blockSize = 64;
+        std::size_t result = 0;
+        while (last - first >= blockSize) {
+            Counter matches = 0;
+            for (std::ptrdiff_t i = 0; i < blockSize; ++i)
+                matches += first[i] == value;
+            result += matches;
+            first += blockSize;
+        }
+        for (; first != last; ++first)
+            result += *first == value;
+        return result;
+    }
+
+    template <typename Container, typename Value>
+    bool contiguous_contains(const Container &container, const Value &value)
+    {
+        search_item_t<ValueType<Container>> needle;
+        if (!to_needle(search_value(value, is_qchar<Value>()), needle))
+            return false;
+        const auto *first = search_data(container);
+        const auto *last = first + container.size();
+        return find_value(first, last, needle) != last;
+    }
+
+    template <typename Container, typename Value>
+    int contiguous_count(const Container &container, const Value &value)
+    {
+        search_item_t<ValueType<Container>> needle;
+        if (!to_needle(search_value(value, is_qchar<Value>()), needle))
+            return 0;
+        const auto *first = search_data(container);
+        return static_cast<int>(count_value(first, first + container.size(), needle));
+    }
+} // namespace detail
+} // namespace kdalgorithms
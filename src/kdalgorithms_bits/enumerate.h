@@ -0,0 +1,239 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "read_iterator_wrapper.h"
+#include "shared.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace kdalgorithms {
+namespace detail {
+    template <typename Iterator>
+    using enumerate_category = std::conditional_t<
+        std::is_base_of<std::random_access_iterator_tag,
+                        typename std::iterator_traits<Iterator>::iterator_category>::value,
+        std::random_access_iterator_tag,
+        typename std::iterator_traits<Iterator>::iterator_category>;
+
+    // Wraps an iterator, and yields pairs of the index and the item. Item is a reference to the
+    // item, which is an r-value reference for r-value containers. It has the same category as the
+    // wrapped iterator, so the random access operations are only available for random access
+    // containers.
+    template <typename Iterator, typename Item>
+    class enumerate_iterator
+    {
+    public:
+        using iterator_category = enumerate_category<Iterator>;
+        using value_type = std::pair<std::size_t, remove_cvref_t<Item>>;
+        using reference = std::pair<std::size_t, Item>;
+        using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+        using pointer = void;
+
+        enumerate_iterator() = default;
+        enumerate_iterator(Iterator iterator, std::size_t index)
+            : m_iterator(std::move(iterator))
+            , m_index(index)
+        {
+        }
+
+        reference operator*() const { return {m_index, *m_iterator}; }
+        reference operator[](difference_type offset) const { return *(*this + offset); }
+
+        enumerate_iterator &operator++()
+        {
+            ++m_iterator;
+            ++m_index;
+            return *this;
+        }
+        enumerate_iterator operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        enumerate_iterator &operator--()
+        {
+            --m_iterator;
+            --m_index;
+            return *this;
+        }
+        enumerate_iterator operator--(int)
+        {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+        enumerate_iterator &operator+=(difference_type offset)
+        {
+            m_iterator += offset;
+            m_index = static_cast<std::size_t>(static_cast<difference_type>(m_index) + offset);
+            return *this;
+        }
+        enumerate_iterator &operator-=(difference_type offset) { return *this += -offset; }
+
+        friend enumerate_iterator operator+(enumerate_iterator it, difference_type offset)
+        {
+            return it += offset;
+        }
+        friend enumerate_iterator operator+(difference_type offset, enumerate_iterator it)
+        {
+            return it += offset;
+        }
+        friend enumerate_iterator operator-(enumerate_iterator it, difference_type offset)
+        {
+            return it -= offset;
+        }
+        friend difference_type operator-(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return static_cast<difference_type>(x.m_index)
+                - static_cast<difference_type>(y.m_index);
+        }
+
+        // The indexes are compared, as they are cheaper to compare than the iterators
+        friend bool operator==(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index == y.m_index;
+        }
+        friend bool operator!=(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index != y.m_index;
+        }
+        friend bool operator<(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index < y.m_index;
+        }
+        friend bool operator>(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index > y.m_index;
+        }
+        friend bool operator<=(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index <= y.m_index;
+        }
+        friend bool operator>=(const enumerate_iterator &x, const enumerate_iterator &y)
+        {
+            return x.m_index >= y.m_index;
+        }
+
+    private:
+        Iterator m_iterator;
+        std::size_t m_index = 0;
+    };
+
+    // Enumerates an l-value container, whose items are given as references.
+    template <typename Container>
+    class enumerate_view
+    {
+        using Iterator = decltype(std::begin(std::declval<Container &>()));
+
+    public:
+        using iterator = enumerate_iterator<Iterator, decltype(*std::declval<Iterator>())>;
+        using const_iterator = iterator;
+        using value_type = typename iterator::value_type;
+        using size_type = std::size_t;
+
+        explicit enumerate_view(Container &container)
+            : m_container(&container)
+        {
+        }
+
+        iterator begin() const { return {std::begin(*m_container), 0}; }
+        iterator end() const { return {std::end(*m_container), size()}; }
+        size_type size() const { return static_cast<size_type>(m_container->size()); }
+        bool empty() const { return size() == 0; }
+
+    private:
+        Container *m_container;
+    };
+
+    // Enumerates an r-value container, which it takes ownership of. Its items are given as
+    // r-value references, like with std::move_iterator, so they are only moved out when the
+    // caller takes the value, and may be read several times before that.
+    // Implicitly shared Qt containers are the exception: whether they share their data is only
+    // known at runtime, and non-const access would then detach them, so their items are given
+    // as const references.
+    template <typename Container>
+    class owning_enumerate_view
+    {
+        using ReadsConst = has_isDetached<Container>;
+        using Source = std::conditional_t<ReadsConst::value, const Container, Container>;
+        using SourceIterator = decltype(std::begin(std::declval<Source &>()));
+        using Iterator = std::conditional_t<ReadsConst::value, SourceIterator,
+                                            std::move_iterator<SourceIterator>>;
+        using Reference = std::conditional_t<ReadsConst::value, const ValueType<Container> &,
+                                             ValueType<Container> &&>;
+
+        static Iterator wrap(SourceIterator it, std::true_type /*reads const*/) { return it; }
+        static Iterator wrap(SourceIterator it, std::false_type /*reads const*/)
+        {
+            return std::make_move_iterator(it);
+        }
+
+    public:
+        using iterator = enumerate_iterator<Iterator, Reference>;
+        using const_iterator = iterator;
+        using value_type = typename iterator::value_type;
+        using size_type = std::size_t;
+
+        explicit owning_enumerate_view(Container &&container)
+            : m_container(std::move(container))
+        {
+        }
+
+        iterator begin() const { return {wrap(std::begin(source()), ReadsConst()), 0}; }
+        iterator end() const { return {wrap(std::end(source()), ReadsConst()), size()}; }
+        size_type size() const { return static_cast<size_type>(m_container.size()); }
+        bool empty() const { return size() == 0; }
+
+    private:
+        Source &source() const { return m_container; }
+
+        mutable Container m_container;
+    };
+
+    template <typename Container>
+    struct is_view<enumerate_view<Container>> : std::true_type
+    {
+    };
+
+    template <typename Container>
+    struct is_view<owning_enumerate_view<Container>> : std::true_type
+    {
+    };
+
+    template <typename Container>
+    auto enumerate(Container &container, std::true_type /*is_lvalue_reference*/)
+    {
+        return enumerate_view<Container>(container);
+    }
+
+    template <typename Container>
+    auto enumerate(Container &container, std::false_type /*is_lvalue_reference*/)
+    {
+        return owning_enumerate_view<Container>(std::move(container));
+    }
+} // namespace detail
+
+// -------------------- enumerate --------------------
+// A view of the items of a container together with their index, as std::pair<std::size_t,
+// Item>, where Item is a reference to the item for l-values, and an r-value reference for
+// r-values, which the view takes ownership of (a const reference for Qt containers). The view has
+// random access iterators for random access containers.
+template <typename Container>
+auto enumerate(Container &&container)
+{
+    return detail::enumerate(container, std::is_lvalue_reference<Container>());
+}
+
+} // namespace kdalgorithms
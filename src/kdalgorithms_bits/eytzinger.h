@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "shared.h"
+#include "to_function_object.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace kdalgorithms {
+
+// A read only lookup structure for containers which are queried many times.
+// The items are stored in Eytzinger order (the order of a breadth first traversal of a
+// balanced binary search tree), so the first levels of the search share a few cache lines,
+// and the search itself is branch free.
+// See https://arxiv.org/abs/1509.05053 for details.
+template <typename T, typename Compare = std::less<T>>
+class eytzinger_index
+{
+public:
+    template <typename Container>
+    explicit eytzinger_index(const Container &container, Compare compare = {})
+        : m_compare(std::move(compare))
+    {
+        std::vector<T> sorted(std::cbegin(container), std::cend(container));
+        std::sort(sorted.begin(), sorted.end(), m_compare);
+        auto last = std::unique(sorted.begin(), sorted.end(), [this](const T &x, const T &y) {
+            return !m_compare(x, y) && !m_compare(y, x);
+        });
+        sorted.erase(last, sorted.end());
+
+        std::vector<std::size_t> order(sorted.size());
+        std::size_t next = 0;
+        fill(order, next, 1);
+
+        m_values.reserve(sorted.size());
+        for (auto index : order)
+            m_values.push_back(std::move(sorted[index]));
+    }
+
+    bool contains(const T &value) const
+    {
+        const std::size_t index = lower_bound(value);
+        return index != 0 && !m_compare(value, m_values[index - 1]);
+    }
+
+    std::size_t size() const { return m_values.size(); }
+    bool empty() const { return m_values.empty(); }
+
+private:
+    // Nodes are numbered from 1, with the children of node k being 2k and 2k+1.
+    // An in-order traversal of the tree visits the nodes in sorted order.
+    static void fill(std::vector<std::size_t> &order, std::size_t &next, std::size_t node)
+    {
+        if (node > order.size())
+            return;
+        fill(order, next, 2 * node);
+        order[node - 1] = next++;
+        fill(order, next, 2 * node + 1);
+    }
+
+    // Returns the node number of the first item not less than value, or 0 if there is none.
+    std::size_t lower_bound(const T &value) const
+    {
+        std::size_t node = 1;
+        while (node <= m_values.size())
+            node = 2 * node + static_cast<std::size_t>(m_compare(m_values[node - 1], value));
+
+        // The path ended with a number of right turns after the last left turn, which was
+        // at the node we are looking for, so strip those along with the left turn.
+        while (node & 1)
+            node >>= 1;
+        return node >> 1;
+    }
+
+    std::vector<T> m_values;
+    Compare m_compare;
+};
+
+template <typename Container, typename Compare = std::less<ValueType<Container>>>
+auto make_eytzinger_index(const Container &container, Compare &&compare = {})
+{
+    auto function = detail::to_function_object(std::forward<Compare>(compare));
+    return eytzinger_index<ValueType<Container>, decltype(function)>(container,
+                                                                     std::move(function));
+}
+
+} // namespace kdalgorithms
@@ -10,21 +10,29 @@
 
 #pragma once
 
+#include "compact.h"
 #include "insert_wrapper.h"
 #include "method_tests.h"
 #include "read_iterator_wrapper.h"
 #include "reserve_helper.h"
 #include "shared.h"
+#include "sink.h"
 #include "to_function_object.h"
 #include <algorithm>
+#include <cassert>
 #include <functional>
 #include <iterator>
+#include <memory>
 
 namespace kdalgorithms {
 namespace detail {
     template <typename ResultContainer, typename InputContainer, typename UnaryPredicate>
     ResultContainer filtered(InputContainer &&input, UnaryPredicate &&predicate)
     {
+        if (is_shared_rvalue<InputContainer>(input))
+            return filtered<ResultContainer>(
+                shared_input<InputContainer>(input),
+                std::forward<UnaryPredicate>(predicate));
         ResultContainer result;
         detail::reserve(result, input.size());
 
@@ -33,6 +41,41 @@ namespace detail {
                      std::forward<UnaryPredicate>(predicate));
         return result;
     }
+
+    template <typename ResultContainer, typename InputContainer, typename UnaryPredicate>
+    ResultContainer filtered(InputContainer &&input, UnaryPredicate &&predicate,
+                             CompactOption /*option*/, std::false_type /*can compact branchless*/)
+    {
+        return filtered<ResultContainer>(std::forward<InputContainer>(input),
+                                         std::forward<UnaryPredicate>(predicate));
+    }
+
+    template <typename ResultContainer, typename InputContainer, typename UnaryPredicate>
+    ResultContainer filtered(InputContainer &&input, UnaryPredicate &&predicate,
+                             CompactOption option, std::true_type /*can compact branchless*/)
+    {
+        if (option == compact_branching || input.size() == 0)
+            return filtered<ResultContainer>(std::forward<InputContainer>(input),
+                                             std::forward<UnaryPredicate>(predicate));
+
+        // Items are trivially copyable, so reading from an r-value is as good as moving.
+        const auto &cinput = input;
+        const auto *first = std::addressof(*std::begin(cinput));
+        ResultContainer result;
+        result.resize(input.size());
+        auto *out = std::addressof(*std::begin(result));
+        auto *end = compact_branchless(first, first + input.size(), out, predicate);
+        result.resize(static_cast<std::size_t>(end - out));
+        return result;
+    }
+
+    template <typename ResultContainer, typename InputContainer>
+    using can_filter_branchless = std::integral_constant<
+        bool,
+        can_compact_branchless<remove_cvref_t<InputContainer>>::value
+            && can_compact_branchless<ResultContainer>::value
+            && std::is_same<ValueType<InputContainer>, ValueType<ResultContainer>>::value
+            && std::is_default_constructible<ValueType<ResultContainer>>::value>;
 }
 
 template <typename Container, typename UnaryPredicate>
@@ -59,6 +102,78 @@ ResultContainer<ValueType<InputContainer>> filtered(InputContainer &&input,
         detail::to_function_object(std::forward<UnaryPredicate>(predicate)));
 }
 
+// With compact_branchless, contiguous containers of trivially copyable items are filtered without
+// branching on the predicate, see compact.h.
+template <typename Container, typename UnaryPredicate>
+auto filtered(Container &&input, UnaryPredicate &&predicate, CompactOption option)
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+{
+    using ResultContainer = remove_cvref_t<Container>;
+    return detail::filtered<ResultContainer>(
+        std::forward<Container>(input),
+        detail::to_function_object(std::forward<UnaryPredicate>(predicate)), option,
+        detail::can_filter_branchless<ResultContainer, Container>());
+}
+
+template <template <typename...> class ResultContainer, typename InputContainer,
+          typename UnaryPredicate>
+ResultContainer<ValueType<InputContainer>>
+filtered(InputContainer &&input, UnaryPredicate &&predicate, CompactOption option)
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, InputContainer>
+#endif
+{
+    using Result = ResultContainer<ValueType<InputContainer>>;
+    return detail::filtered<Result>(
+        std::forward<InputContainer>(input),
+        detail::to_function_object(std::forward<UnaryPredicate>(predicate)), option,
+        detail::can_filter_branchless<Result, InputContainer>());
+}
+
+// Hands the matching items to sink (see to_sink) one by one, rather than returning them in a
+// container.
+template <typename InputContainer, typename UnaryPredicate, typename Sink>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, InputContainer>
+#endif
+void filtered(InputContainer &&input, UnaryPredicate &&predicate, detail::sink_iterator<Sink> sink)
+{
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        filtered(detail::shared_input<InputContainer>(input),
+                 std::forward<UnaryPredicate>(predicate), std::move(sink));
+        return;
+    }
+    auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+    std::copy_if(range.begin(), range.end(), std::move(sink),
+                 detail::to_function_object(std::forward<UnaryPredicate>(predicate)));
+}
+
+// -------------------- filter_into --------------------
+// Copies (or moves for r-values) the items matching predicate into output, which typically is a
+// long lived buffer, whose capacity is reused. output is cleared first, unless option is
+// append_to_output.
+template <typename InputContainer, typename OutputContainer, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, InputContainer>
+    && ContainerOfType<OutputContainer, ValueType<InputContainer>>
+#endif
+void filter_into(InputContainer &&input, OutputContainer &output, UnaryPredicate &&predicate,
+                 OutputOption option = overwrite_output)
+{
+    assert(!detail::is_same_object(input, output));
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        filter_into(detail::shared_input<InputContainer>(input), output,
+                    std::forward<UnaryPredicate>(predicate), option);
+        return;
+    }
+    detail::prepare_output(output, input.size(), option);
+    auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+    std::copy_if(range.begin(), range.end(), detail::insert_wrapper(output),
+                 detail::to_function_object(std::forward<UnaryPredicate>(predicate)));
+}
+
 // -------------------- filter --------------------
 template <typename Container, typename UnaryPredicate>
 void filter(Container &input, UnaryPredicate &&predicate)
@@ -76,4 +191,33 @@ void filter(Container &input, UnaryPredicate &&predicate)
     input.erase(it, std::end(input));
 }
 
+namespace detail {
+    template <typename Container, typename UnaryPredicate>
+    void filter(Container &input, UnaryPredicate &&predicate, CompactOption /*option*/,
+                std::false_type /*can compact branchless*/)
+    {
+        kdalgorithms::filter(input, std::forward<UnaryPredicate>(predicate));
+    }
+
+    template <typename Container, typename UnaryPredicate>
+    void filter(Container &input, UnaryPredicate &&predicate, CompactOption option,
+                std::true_type /*can compact branchless*/)
+    {
+        if (option == compact_branching)
+            kdalgorithms::filter(input, std::forward<UnaryPredicate>(predicate));
+        else
+            compact_in_place(input, std::forward<UnaryPredicate>(predicate));
+    }
+}
+
+template <typename Container, typename UnaryPredicate>
+void filter(Container &input, UnaryPredicate &&predicate, CompactOption option)
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+{
+    detail::filter(input, detail::to_function_object(std::forward<UnaryPredicate>(predicate)),
+                   option, detail::can_compact_branchless<Container>());
+}
+
 } // namespace kdalgorithms
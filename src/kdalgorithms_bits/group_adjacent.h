@@ -0,0 +1,289 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "invoke.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "subrange.h"
+#include "to_function_object.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdalgorithms {
+
+// The items of a group are a subrange for group_adjacent, and a container for grouped_adjacent.
+template <typename Key, typename Items>
+struct adjacent_group
+{
+    Key key;
+    Items items;
+};
+
+namespace detail {
+    // Iterates the runs of consecutive items for which belongsTogether(previous, current) is
+    // true. Finding the end of a run is done when the iterator arrives at it, so the view
+    // itself doesn't allocate anything.
+    template <typename Iterator, typename BelongsTogether>
+    class run_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = subrange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        run_iterator(Iterator begin, Iterator end, const BelongsTogether *belongsTogether)
+            : m_begin(std::move(begin))
+            , m_runEnd(m_begin)
+            , m_end(std::move(end))
+            , m_belongsTogether(belongsTogether)
+        {
+            findRunEnd();
+        }
+
+        value_type operator*() const { return {m_begin, m_runEnd}; }
+
+        run_iterator &operator++()
+        {
+            m_begin = m_runEnd;
+            findRunEnd();
+            return *this;
+        }
+
+        run_iterator operator++(int)
+        {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+
+        bool operator==(const run_iterator &other) const { return m_begin == other.m_begin; }
+        bool operator!=(const run_iterator &other) const { return m_begin != other.m_begin; }
+
+    private:
+        void findRunEnd()
+        {
+            if (m_runEnd == m_end)
+                return;
+            auto previous = m_runEnd;
+            for (++m_runEnd; m_runEnd != m_end && (*m_belongsTogether)(*previous, *m_runEnd);
+                 ++m_runEnd)
+                previous = m_runEnd;
+        }
+
+        Iterator m_begin;
+        Iterator m_runEnd;
+        Iterator m_end;
+        const BelongsTogether *m_belongsTogether;
+    };
+
+    template <typename Iterator, typename BelongsTogether>
+    class run_view
+    {
+    public:
+        using iterator = run_iterator<Iterator, BelongsTogether>;
+        using const_iterator = iterator;
+        using value_type = subrange<Iterator>;
+        using size_type = std::size_t;
+
+        run_view(Iterator begin, Iterator end, BelongsTogether belongsTogether)
+            : m_begin(std::move(begin))
+            , m_end(std::move(end))
+            , m_belongsTogether(std::move(belongsTogether))
+        {
+        }
+
+        iterator begin() const { return {m_begin, m_end, &m_belongsTogether}; }
+        iterator end() const { return {m_end, m_end, &m_belongsTogether}; }
+
+        // Linear in the number of items, as the runs must be found.
+        size_type size() const { return static_cast<size_type>(std::distance(begin(), end())); }
+        bool empty() const { return m_begin == m_end; }
+
+    private:
+        Iterator m_begin;
+        Iterator m_end;
+        BelongsTogether m_belongsTogether;
+    };
+
+    template <typename Iterator, typename BelongsTogether>
+    struct is_view<run_view<Iterator, BelongsTogether>> : std::true_type
+    {
+    };
+
+    template <typename KeyFunction>
+    auto same_key(KeyFunction keyFunction)
+    {
+        return [keyFunction](const auto &x, const auto &y) {
+            return detail::invoke(keyFunction, x) == detail::invoke(keyFunction, y);
+        };
+    }
+
+    // Adds the key of each run to what run_view yields
+    template <typename Iterator, typename KeyFunction>
+    class group_iterator
+    {
+        using RunIterator = run_iterator<Iterator, decltype(same_key(std::declval<KeyFunction>()))>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = adjacent_group<
+            remove_cvref_t<decltype(detail::invoke(std::declval<const KeyFunction &>(),
+                                                   *std::declval<Iterator>()))>,
+            subrange<Iterator>>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        group_iterator(RunIterator run, const KeyFunction *keyFunction)
+            : m_run(std::move(run))
+            , m_keyFunction(keyFunction)
+        {
+        }
+
+        value_type operator*() const
+        {
+            auto items = *m_run;
+            return {detail::invoke(*m_keyFunction, items.front()), items};
+        }
+
+        group_iterator &operator++()
+        {
+            ++m_run;
+            return *this;
+        }
+
+        group_iterator operator++(int)
+        {
+            auto result = *this;
+            ++m_run;
+            return result;
+        }
+
+        bool operator==(const group_iterator &other) const { return m_run == other.m_run; }
+        bool operator!=(const group_iterator &other) const { return m_run != other.m_run; }
+
+    private:
+        RunIterator m_run;
+        const KeyFunction *m_keyFunction;
+    };
+
+    template <typename Iterator, typename KeyFunction>
+    class group_view
+    {
+        using SameKey = decltype(same_key(std::declval<KeyFunction>()));
+
+    public:
+        using iterator = group_iterator<Iterator, KeyFunction>;
+        using const_iterator = iterator;
+        using value_type = typename iterator::value_type;
+        using size_type = std::size_t;
+
+        group_view(Iterator begin, Iterator end, KeyFunction keyFunction)
+            : m_keyFunction(std::move(keyFunction))
+            , m_runs(std::move(begin), std::move(end), same_key(m_keyFunction))
+        {
+        }
+
+        iterator begin() const { return {m_runs.begin(), &m_keyFunction}; }
+        iterator end() const { return {m_runs.end(), &m_keyFunction}; }
+
+        // Linear in the number of items, as the runs must be found.
+        size_type size() const { return m_runs.size(); }
+        bool empty() const { return m_runs.empty(); }
+
+    private:
+        KeyFunction m_keyFunction;
+        run_view<Iterator, SameKey> m_runs;
+    };
+
+    template <typename Iterator, typename KeyFunction>
+    struct is_view<group_view<Iterator, KeyFunction>> : std::true_type
+    {
+    };
+} // namespace detail
+
+// -------------------- group_adjacent / chunk_by --------------------
+// Views of the runs of consecutive items with the same key. The views refer into the container,
+// so they can't be used with temporaries.
+template <typename Container, typename KeyFunction>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<KeyFunction, ValueType<Container>>
+#endif
+auto group_adjacent(Container &&container, KeyFunction keyFunction)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "group_adjacent refers into the container, so it can't be used with temporaries");
+    using Iterator = decltype(std::begin(container));
+    return detail::group_view<Iterator, KeyFunction>(std::begin(container), std::end(container),
+                                                     std::move(keyFunction));
+}
+
+template <typename Container, typename BinaryPredicate>
+#if __cplusplus >= 202002L
+    requires BinaryPredicateOnContainerValues<BinaryPredicate, Container>
+#endif
+auto chunk_by(Container &&container, BinaryPredicate &&belongsTogether)
+{
+    static_assert(std::is_lvalue_reference<Container>::value,
+                  "chunk_by refers into the container, so it can't be used with temporaries");
+    using Iterator = decltype(std::begin(container));
+    auto function = detail::to_function_object(std::forward<BinaryPredicate>(belongsTogether));
+    return detail::run_view<Iterator, decltype(function)>(std::begin(container),
+                                                          std::end(container), std::move(function));
+}
+
+namespace detail {
+    template <typename ResultContainer, typename IsLValue, typename Items, typename KeyFunction>
+    auto grouped_adjacent(Items &&container, KeyFunction keyFunction)
+    {
+        auto groups = group_adjacent(container, std::move(keyFunction));
+        using Key = decltype(std::declval<typename decltype(groups)::value_type>().key);
+
+        std::vector<adjacent_group<Key, ResultContainer>> result;
+        result.reserve(groups.size());
+        for (auto &&group : groups) {
+            result.push_back({std::move(group.key), {}});
+            auto &items = result.back().items;
+            detail::reserve(items, group.items.size());
+            detail::copy_or_move(group.items.begin(), group.items.end(),
+                                 detail::insert_wrapper(items), IsLValue());
+        }
+        return result;
+    }
+} // namespace detail
+
+// -------------------- grouped_adjacent --------------------
+// Like group_adjacent, but copies (or moves) the items of each run into a container of its own.
+// Returns a std::vector of adjacent_group<Key, Container>.
+template <typename Container, typename KeyFunction>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<KeyFunction, ValueType<Container>>
+#endif
+auto grouped_adjacent(Container &&container, KeyFunction keyFunction)
+{
+    using ResultContainer = remove_cvref_t<Container>;
+    using IsLValue = std::is_lvalue_reference<Container>;
+    // A shared r-value is read through const iterators, so its items are copied, not moved
+    if (detail::is_shared_rvalue<Container>(container))
+        return detail::grouped_adjacent<ResultContainer, IsLValue>(
+            detail::shared_input<Container>(container), std::move(keyFunction));
+    return detail::grouped_adjacent<ResultContainer, IsLValue>(container, std::move(keyFunction));
+}
+
+} // namespace kdalgorithms
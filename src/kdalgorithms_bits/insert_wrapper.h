@@ -11,11 +11,18 @@
 #pragma once
 
 #include "method_tests.h"
+#include "reserve_helper.h"
 #include "shared.h"
+#include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <utility>
 
 namespace kdalgorithms {
+// What transform_into, filter_into and filtered_transformed_into do with the items already in
+// the output container.
+enum OutputOption { overwrite_output, append_to_output };
+
 namespace detail {
     template <class Container, typename T>
     using has_push_back = decltype(std::declval<Container &>().push_back(std::declval<T>()));
@@ -42,10 +49,24 @@ namespace detail {
         return std::inserter<Container>(c, c.end());
     }
 
+    template <class Map>
+    using has_emplace = decltype(std::declval<Map &>().emplace(
+        std::declval<typename Map::key_type>(), std::declval<typename Map::mapped_type>()));
+
+    template <class Map>
+    using has_hinted_insert = decltype(std::declval<Map &>().insert(
+        std::declval<typename Map::const_iterator>(), std::declval<typename Map::key_type>(),
+        std::declval<typename Map::mapped_type>()));
+
     // similar to std::inserter, but for QMap/QHash which usually accept a value in their operator=
+    // Pairs given as r-values are moved into the map if it supports that (QHash::emplace in Qt 6).
+    // Otherwise, like std::inserter, the items are inserted right after the previous one, which
+    // makes inserting already sorted items into a QMap take constant time per item.
     template <typename T>
     class qmap_inserter
     {
+        using Pair = std::pair<typename T::key_type, typename T::mapped_type>;
+
     public:
         using iterator_category = std::output_iterator_tag;
         using value_type = ValueType<T>;
@@ -55,20 +76,49 @@ namespace detail {
 
         qmap_inserter(T *map)
             : m_map(map)
+            , m_hint(map->end()) // non-const end() detaches the map, which keeps m_hint valid
         {
         }
 
         qmap_inserter &operator++() { return *this; }
         qmap_inserter &operator*() { return *this; }
-        qmap_inserter &
-        operator=(const std::pair<typename T::key_type, typename T::mapped_type> &pair)
+        qmap_inserter &operator=(const Pair &pair)
+        {
+            insert(pair.first, pair.second, is_detected<has_emplace, T>(),
+                   is_detected<has_hinted_insert, T>());
+            return *this;
+        }
+        qmap_inserter &operator=(Pair &&pair)
         {
-            m_map->insert(pair.first, pair.second);
+            insert(std::move(pair.first), std::move(pair.second), is_detected<has_emplace, T>(),
+                   is_detected<has_hinted_insert, T>());
             return *this;
         }
 
     private:
+        template <typename Key, typename Value, typename HasHintedInsert>
+        void insert(Key &&key, Value &&value, std::true_type /*has_emplace*/, HasHintedInsert)
+        {
+            m_map->emplace(std::forward<Key>(key), std::forward<Value>(value));
+        }
+
+        template <typename Key, typename Value>
+        void insert(Key &&key, Value &&value, std::false_type /*has_emplace*/,
+                    std::true_type /*has_hinted_insert*/)
+        {
+            m_hint = m_map->insert(m_hint, std::forward<Key>(key), std::forward<Value>(value));
+            ++m_hint;
+        }
+
+        template <typename Key, typename Value>
+        void insert(Key &&key, Value &&value, std::false_type /*has_emplace*/,
+                    std::false_type /*has_hinted_insert*/)
+        {
+            m_map->insert(std::forward<Key>(key), std::forward<Value>(value));
+        }
+
         T *m_map;
+        typename T::iterator m_hint;
     };
 
     template <typename Container>
@@ -78,5 +128,33 @@ namespace detail {
         return qmap_inserter<Container>(&c);
     }
 
+    // Prepares output for receiving at most count items. clear() keeps the capacity of the
+    // containers, so a long lived output stops allocating once it has grown large enough.
+    // Reserving for every append would grow the capacity by count each time rather than
+    // geometrically, so that is only done for empty output.
+    template <typename Container>
+    void prepare_output(Container &output, std::size_t count, OutputOption option)
+    {
+        if (option == overwrite_output)
+            output.clear();
+        if (output.empty())
+            detail::reserve(output, static_cast<typename Container::size_type>(count));
+    }
+
+    // Copies the items of l-value containers, and moves the items of r-value containers.
+    template <typename Iterator, typename OutputIterator>
+    void copy_or_move(Iterator first, Iterator last, OutputIterator out,
+                      std::true_type /*is_lvalue_reference*/)
+    {
+        std::copy(first, last, out);
+    }
+
+    template <typename Iterator, typename OutputIterator>
+    void copy_or_move(Iterator first, Iterator last, OutputIterator out,
+                      std::false_type /*is_lvalue_reference*/)
+    {
+        std::move(first, last, out);
+    }
+
 } // namespace detail
 } // namespace kdalgorithms
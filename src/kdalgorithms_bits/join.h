@@ -0,0 +1,314 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "invoke.h"
+#include "method_tests.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    constexpr std::size_t no_join_match = static_cast<std::size_t>(-1);
+
+    template <typename Range>
+    auto join_iterators(Range range)
+    {
+        std::vector<decltype(range.begin())> result;
+        result.reserve(static_cast<std::size_t>(std::distance(range.begin(), range.end())));
+        for (auto it = range.begin(); it != range.end(); ++it)
+            result.push_back(it);
+        return result;
+    }
+
+    template <typename Key, typename Iterators, typename KeyFunction>
+    std::vector<Key> join_keys(const Iterators &iterators, KeyFunction &keyFunction)
+    {
+        std::vector<Key> result;
+        result.reserve(iterators.size());
+        for (const auto &it : iterators)
+            result.push_back(detail::invoke(keyFunction, *it));
+        return result;
+    }
+
+    // Both sides are sorted by key, so walk them in parallel.
+    template <typename Key, typename Visitor>
+    void merge_join(const std::vector<Key> &leftKeys, const std::vector<Key> &rightKeys,
+                    Visitor &visit)
+    {
+        std::size_t left = 0;
+        std::size_t right = 0;
+        while (left < leftKeys.size() && right < rightKeys.size()) {
+            if (leftKeys[left] < rightKeys[right]) {
+                ++left;
+            } else if (rightKeys[right] < leftKeys[left]) {
+                ++right;
+            } else {
+                std::size_t rightEnd = right + 1;
+                while (rightEnd < rightKeys.size() && !(leftKeys[left] < rightKeys[rightEnd]))
+                    ++rightEnd;
+                const Key &key = rightKeys[right];
+                for (; left < leftKeys.size() && !(key < leftKeys[left]); ++left) {
+                    for (std::size_t index = right; index < rightEnd; ++index)
+                        visit(left, index);
+                }
+                right = rightEnd;
+            }
+        }
+    }
+
+    // Builds a hash table of the keys of one side, and probes it with the keys of the other.
+    // Items with the same key are chained through the next vector, in ascending order.
+    template <typename Key, typename Visitor>
+    void hash_join(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys, bool keepLeftOrder,
+                   Visitor &visit)
+    {
+        const bool buildLeft = !keepLeftOrder && leftKeys.size() < rightKeys.size();
+        auto &buildKeys = buildLeft ? leftKeys : rightKeys;
+        const auto &probeKeys = buildLeft ? rightKeys : leftKeys;
+
+        std::unordered_map<Key, std::size_t> heads;
+        heads.reserve(buildKeys.size());
+        std::vector<std::size_t> next(buildKeys.size(), no_join_match);
+        for (std::size_t index = buildKeys.size(); index-- > 0;) {
+            auto result = heads.emplace(std::move(buildKeys[index]), index);
+            if (!result.second) {
+                next[index] = result.first->second;
+                result.first->second = index;
+            }
+        }
+
+        for (std::size_t probe = 0; probe < probeKeys.size(); ++probe) {
+            auto it = heads.find(probeKeys[probe]);
+            if (it == heads.end())
+                continue;
+            for (std::size_t index = it->second; index != no_join_match; index = next[index]) {
+                if (buildLeft)
+                    visit(index, probe);
+                else
+                    visit(probe, index);
+            }
+        }
+    }
+
+    // Sorts the indexes of the right side by key, and binary searches it for each left key.
+    template <typename Key, typename Visitor>
+    void sort_join(const std::vector<Key> &leftKeys, const std::vector<Key> &rightKeys,
+                   Visitor &visit)
+    {
+        std::vector<std::size_t> order(rightKeys.size());
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&rightKeys](std::size_t x, std::size_t y) {
+            return rightKeys[x] < rightKeys[y];
+        });
+
+        for (std::size_t left = 0; left < leftKeys.size(); ++left) {
+            const Key &key = leftKeys[left];
+            auto first = std::lower_bound(
+                order.begin(), order.end(), key,
+                [&rightKeys](std::size_t index, const Key &key) { return rightKeys[index] < key; });
+            for (; first != order.end() && !(key < rightKeys[*first]); ++first)
+                visit(left, *first);
+        }
+    }
+
+    template <typename Key, typename Visitor>
+    void join_unsorted(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys, bool keepLeftOrder,
+                       Visitor &visit, std::true_type /*has_std_hash*/)
+    {
+        hash_join(leftKeys, rightKeys, keepLeftOrder, visit);
+    }
+
+    template <typename Key, typename Visitor>
+    void join_unsorted(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys,
+                       bool /*keepLeftOrder*/, Visitor &visit, std::false_type /*has_std_hash*/)
+    {
+        sort_join(leftKeys, rightKeys, visit);
+    }
+
+    template <typename Key, typename Visitor, typename HasHash>
+    void join_indexes(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys, bool keepLeftOrder,
+                      Visitor &visit, std::true_type /*has_operator_lt*/, HasHash hasHash)
+    {
+        if (std::is_sorted(leftKeys.cbegin(), leftKeys.cend())
+            && std::is_sorted(rightKeys.cbegin(), rightKeys.cend()))
+            merge_join(leftKeys, rightKeys, visit);
+        else
+            join_unsorted(leftKeys, rightKeys, keepLeftOrder, visit, hasHash);
+    }
+
+    template <typename Key, typename Visitor>
+    void join_indexes(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys, bool keepLeftOrder,
+                      Visitor &visit, std::false_type /*has_operator_lt*/,
+                      std::true_type /*has_std_hash*/)
+    {
+        hash_join(leftKeys, rightKeys, keepLeftOrder, visit);
+    }
+
+    template <typename Key, typename Visitor>
+    void join_indexes(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys,
+                      bool /*keepLeftOrder*/, Visitor &visit, std::false_type /*has_operator_lt*/,
+                      std::false_type /*has_std_hash*/)
+    {
+        for (std::size_t left = 0; left < leftKeys.size(); ++left) {
+            for (std::size_t right = 0; right < rightKeys.size(); ++right) {
+                if (leftKeys[left] == rightKeys[right])
+                    visit(left, right);
+            }
+        }
+    }
+
+    // Calls visit(leftIndex, rightIndex) for each pair of items with equal keys.
+    // If keepLeftOrder is true, the pairs are visited in the order of the left indexes.
+    template <typename Key, typename Visitor>
+    void join_indexes(std::vector<Key> &leftKeys, std::vector<Key> &rightKeys, bool keepLeftOrder,
+                      Visitor &&visit)
+    {
+        join_indexes(leftKeys, rightKeys, keepLeftOrder, visit,
+                     std::integral_constant<bool, has_operator_lt_v<Key>>(),
+                     std::integral_constant<bool, has_std_hash_v<Key>>());
+    }
+
+    template <typename Container, typename KeyFunction>
+    using join_key_t = remove_cvref_t<decltype(detail::invoke(
+        std::declval<KeyFunction &>(),
+        *read_iterator_wrapper(std::declval<const remove_cvref_t<Container> &>()).begin()))>;
+
+    template <typename LeftContainer, typename RightContainer, typename LeftKey, typename RightKey>
+    using common_join_key_t = std::common_type_t<join_key_t<LeftContainer, LeftKey>,
+                                                 join_key_t<RightContainer, RightKey>>;
+
+    // Returns a vector telling for each item of left whether it has a match in right.
+    template <typename LeftContainer, typename RightContainer, typename LeftKey, typename RightKey>
+    std::vector<char> join_matches(const LeftContainer &left, const RightContainer &right,
+                                   LeftKey &leftKey, RightKey &rightKey)
+    {
+        using Key = common_join_key_t<LeftContainer, RightContainer, LeftKey, RightKey>;
+        auto leftKeys = join_keys<Key>(join_iterators(read_iterator_wrapper(left)), leftKey);
+        auto rightKeys = join_keys<Key>(join_iterators(read_iterator_wrapper(right)), rightKey);
+        std::vector<char> matches(leftKeys.size(), false);
+        join_indexes(leftKeys, rightKeys, false,
+                     [&matches](std::size_t left, std::size_t) { matches[left] = true; });
+        return matches;
+    }
+
+    template <typename LeftContainer, typename Matches>
+    remove_cvref_t<LeftContainer> filtered_by_matches(LeftContainer &&left, const Matches &matches,
+                                                      bool keep)
+    {
+        if (is_shared_rvalue<LeftContainer>(left))
+            return filtered_by_matches(shared_input<LeftContainer>(left), matches, keep);
+        remove_cvref_t<LeftContainer> result;
+        detail::reserve(result, static_cast<std::size_t>(
+                                    std::count(matches.cbegin(), matches.cend(), keep)));
+        auto inserter = detail::insert_wrapper(result);
+        auto range = read_iterator_wrapper(std::forward<LeftContainer>(left));
+        std::size_t index = 0;
+        for (auto it = range.begin(); it != range.end(); ++it, ++index) {
+            if (static_cast<bool>(matches[index]) == keep) {
+                *inserter = *it;
+                ++inserter;
+            }
+        }
+        return result;
+    }
+} // namespace detail
+
+// -------------------- joined / left_joined --------------------
+template <template <typename...> class ResultContainerClass = std::vector, typename LeftContainer,
+          typename RightContainer, typename LeftKey, typename RightKey, typename Combine>
+auto joined(const LeftContainer &left, const RightContainer &right, LeftKey &&leftKey,
+            RightKey &&rightKey, Combine &&combine)
+{
+    using Key = detail::common_join_key_t<LeftContainer, RightContainer, LeftKey, RightKey>;
+    const auto leftItems = detail::join_iterators(read_iterator_wrapper(left));
+    const auto rightItems = detail::join_iterators(read_iterator_wrapper(right));
+    auto leftKeys = detail::join_keys<Key>(leftItems, leftKey);
+    auto rightKeys = detail::join_keys<Key>(rightItems, rightKey);
+
+    auto function = detail::to_function_object(std::forward<Combine>(combine));
+    using ResultItemType = remove_cvref_t<decltype(function(*leftItems[0], *rightItems[0]))>;
+    ResultContainerClass<ResultItemType> result;
+    auto inserter = detail::insert_wrapper(result);
+    detail::join_indexes(leftKeys, rightKeys, true, [&](std::size_t left, std::size_t right) {
+        *inserter = function(*leftItems[left], *rightItems[right]);
+        ++inserter;
+    });
+    return result;
+}
+
+template <template <typename...> class ResultContainerClass = std::vector, typename LeftContainer,
+          typename RightContainer, typename LeftKey, typename RightKey, typename Combine>
+auto left_joined(const LeftContainer &left, const RightContainer &right, LeftKey &&leftKey,
+                 RightKey &&rightKey, Combine &&combine)
+{
+    using Key = detail::common_join_key_t<LeftContainer, RightContainer, LeftKey, RightKey>;
+    const auto leftItems = detail::join_iterators(read_iterator_wrapper(left));
+    const auto rightItems = detail::join_iterators(read_iterator_wrapper(right));
+    auto leftKeys = detail::join_keys<Key>(leftItems, leftKey);
+    auto rightKeys = detail::join_keys<Key>(rightItems, rightKey);
+
+    auto function = detail::to_function_object(std::forward<Combine>(combine));
+    using RightItemType = std::remove_reference_t<decltype(*rightItems[0])>;
+    using ResultItemType = remove_cvref_t<decltype(function(
+        *leftItems[0], static_cast<const RightItemType *>(nullptr)))>;
+    ResultContainerClass<ResultItemType> result;
+    auto inserter = detail::insert_wrapper(result);
+
+    // The matches are visited in the order of the left items, so the items without a match
+    // are the ones skipped between two visits.
+    std::size_t nextLeft = 0;
+    auto addUnmatched = [&](std::size_t until) {
+        for (; nextLeft < until; ++nextLeft) {
+            *inserter = function(*leftItems[nextLeft], static_cast<const RightItemType *>(nullptr));
+            ++inserter;
+        }
+    };
+    detail::join_indexes(leftKeys, rightKeys, true, [&](std::size_t left, std::size_t right) {
+        addUnmatched(left);
+        nextLeft = left + 1;
+        auto &&rightItem = *rightItems[right];
+        *inserter = function(*leftItems[left], std::addressof(rightItem));
+        ++inserter;
+    });
+    addUnmatched(leftItems.size());
+    return result;
+}
+
+// -------------------- semi_joined / anti_joined --------------------
+template <typename LeftContainer, typename RightContainer, typename LeftKey, typename RightKey>
+auto semi_joined(LeftContainer &&left, const RightContainer &right, LeftKey &&leftKey,
+                 RightKey &&rightKey)
+{
+    const auto matches = detail::join_matches(left, right, leftKey, rightKey);
+    return detail::filtered_by_matches(std::forward<LeftContainer>(left), matches, true);
+}
+
+template <typename LeftContainer, typename RightContainer, typename LeftKey, typename RightKey>
+auto anti_joined(LeftContainer &&left, const RightContainer &right, LeftKey &&leftKey,
+                 RightKey &&rightKey)
+{
+    const auto matches = detail::join_matches(left, right, leftKey, rightKey);
+    return detail::filtered_by_matches(std::forward<LeftContainer>(left), matches, false);
+}
+
+} // namespace kdalgorithms
@@ -0,0 +1,286 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    // A tournament tree, which keeps track of which of a number of sorted sources has the
+    // smallest head item. Each internal node stores the loser of the match played there, so
+    // replacing the head of the winning source only needs to replay the matches on its path to
+    // the root, which is one comparison per level.
+    // Heads are pointers to the current item of each source, nullptr when a source is exhausted.
+    template <typename Pointer, typename Compare>
+    class loser_tree
+    {
+    public:
+        static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        loser_tree(std::vector<Pointer> heads, Compare &compare)
+            : m_heads(std::move(heads))
+            , m_losers(m_heads.size())
+            , m_compare(compare)
+        {
+            if (!m_heads.empty())
+                m_losers[0] = build(1);
+        }
+
+        // The source with the smallest head, or none if all sources are exhausted.
+        std::size_t winner() const
+        {
+            if (m_heads.empty() || m_heads[m_losers[0]] == nullptr)
+                return none;
+            return m_losers[0];
+        }
+
+        Pointer head(std::size_t source) const { return m_heads[source]; }
+
+        void replace_winner(Pointer head)
+        {
+            std::size_t winner = m_losers[0];
+            m_heads[winner] = head;
+            for (std::size_t node = (winner + m_heads.size()) / 2; node > 0; node /= 2) {
+                if (less(m_losers[node], winner))
+                    std::swap(m_losers[node], winner);
+            }
+            m_losers[0] = winner;
+        }
+
+    private:
+        // Nodes 1 to size - 1 are the internal nodes, with node n having the children 2n and
+        // 2n + 1. Nodes size to 2 * size - 1 are the leaves, one per source.
+        std::size_t build(std::size_t node)
+        {
+            if (node >= m_heads.size())
+                return node - m_heads.size();
+            const std::size_t left = build(2 * node);
+            const std::size_t right = build(2 * node + 1);
+            if (less(right, left)) {
+                m_losers[node] = left;
+                return right;
+            }
+            m_losers[node] = right;
+            return left;
+        }
+
+        // Exhausted sources lose to everything, and ties are won by the lower source index,
+        // which makes the merge stable.
+        bool less(std::size_t x, std::size_t y) const
+        {
+            if (m_heads[x] == nullptr)
+                return false;
+            if (m_heads[y] == nullptr)
+                return true;
+            if (m_compare(*m_heads[x], *m_heads[y]))
+                return true;
+            if (m_compare(*m_heads[y], *m_heads[x]))
+                return false;
+            return x < y;
+        }
+
+        std::vector<Pointer> m_heads;
+        std::vector<std::size_t> m_losers;
+        Compare &m_compare;
+    };
+
+    template <typename Iterator>
+    auto head_pointer(Iterator it, Iterator end)
+    {
+        return it == end ? nullptr : std::addressof(*it);
+    }
+
+    // Items are moved out of r-value containers, and copied out of l-value containers.
+    template <typename T>
+    T &&merge_item(T &item, std::false_type /*is_lvalue_reference*/)
+    {
+        return std::move(item);
+    }
+
+    template <typename T>
+    const T &merge_item(const T &item, std::true_type /*is_lvalue_reference*/)
+    {
+        return item;
+    }
+
+    template <typename Container>
+    auto merge_range(Container &container, std::false_type /*is_lvalue_reference*/)
+    {
+        return std::make_pair(std::begin(container), std::end(container));
+    }
+
+    template <typename Container>
+    auto merge_range(const Container &container, std::true_type /*is_lvalue_reference*/)
+    {
+        return std::make_pair(std::cbegin(container), std::cend(container));
+    }
+
+    // Merges the sources, whose ranges are given as a vector of begin/end pairs.
+    template <typename ResultContainer, typename IsLValue, typename Ranges, typename Compare>
+    ResultContainer merged_ranges(Ranges &ranges, Compare &compare)
+    {
+        std::size_t total = 0;
+        std::vector<decltype(head_pointer(ranges[0].first, ranges[0].second))> heads;
+        heads.reserve(ranges.size());
+        for (auto &range : ranges) {
+            total += static_cast<std::size_t>(std::distance(range.first, range.second));
+            heads.push_back(head_pointer(range.first, range.second));
+        }
+
+        ResultContainer result;
+        detail::reserve(result, total);
+        auto inserter = detail::insert_wrapper(result);
+
+        loser_tree<typename decltype(heads)::value_type, Compare> tree(std::move(heads), compare);
+        for (auto source = tree.winner(); source != tree.none; source = tree.winner()) {
+            *inserter = merge_item(*tree.head(source), IsLValue());
+            ++inserter;
+            auto &range = ranges[source];
+            tree.replace_winner(head_pointer(++range.first, range.second));
+        }
+        return result;
+    }
+
+    template <typename ResultContainer, typename IsLValue, typename Containers, typename Compare>
+    ResultContainer merged_containers(Containers &containers, Compare &compare)
+    {
+        using Range = decltype(merge_range(*std::begin(containers), IsLValue()));
+        std::vector<Range> ranges;
+        ranges.reserve(static_cast<std::size_t>(
+            std::distance(std::begin(containers), std::end(containers))));
+        for (auto &container : containers)
+            ranges.push_back(merge_range(container, IsLValue()));
+        return merged_ranges<ResultContainer, IsLValue>(ranges, compare);
+    }
+
+    template <bool... values>
+    using all_true = std::is_same<std::integer_sequence<bool, true, values...>,
+                                  std::integer_sequence<bool, values..., true>>;
+
+    // If any of the r-value sources is shared (see is_shared_rvalue), all of them are read like
+    // const l-values.
+    template <typename Containers>
+    bool any_shared(const Containers &containers)
+    {
+        if (is_shared(containers))
+            return true;
+        for (const auto &container : containers) {
+            if (is_shared(container))
+                return true;
+        }
+        return false;
+    }
+
+    template <typename ResultContainer, typename Containers, typename Compare, typename MayBeShared>
+    ResultContainer merged_sources(const Containers &containers, Compare &compare,
+                                   std::true_type /*is_lvalue_reference*/, MayBeShared)
+    {
+        return merged_containers<ResultContainer, std::true_type>(containers, compare);
+    }
+
+    template <typename ResultContainer, typename Containers, typename Compare>
+    ResultContainer merged_sources(Containers &containers, Compare &compare,
+                                   std::false_type /*is_lvalue_reference*/,
+                                   std::false_type /*may be shared*/)
+    {
+        return merged_containers<ResultContainer, std::false_type>(containers, compare);
+    }
+
+    template <typename ResultContainer, typename Containers, typename Compare>
+    ResultContainer merged_sources(Containers &containers, Compare &compare,
+                                   std::false_type /*is_lvalue_reference*/,
+                                   std::true_type /*may be shared*/)
+    {
+        if (any_shared(containers))
+            return merged_containers<ResultContainer, std::true_type>(
+                static_cast<const Containers &>(containers), compare);
+        return merged_containers<ResultContainer, std::false_type>(containers, compare);
+    }
+
+    // The same for sources given as separate arguments
+    template <typename ResultContainer, typename IsLValue, typename Compare,
+              typename... Containers>
+    ResultContainer merged_arguments(Compare &compare, IsLValue, std::false_type /*may be shared*/,
+                                     Containers &...containers)
+    {
+        using Range = decltype(merge_range(std::get<0>(std::tie(containers...)), IsLValue()));
+        std::vector<Range> ranges{merge_range(containers, IsLValue())...};
+        return merged_ranges<ResultContainer, IsLValue>(ranges, compare);
+    }
+
+    template <typename ResultContainer, typename IsLValue, typename Compare,
+              typename... Containers>
+    ResultContainer merged_arguments(Compare &compare, IsLValue, std::true_type /*may be shared*/,
+                                     Containers &...containers)
+    {
+        bool anyShared = false;
+        int dummy[] = {(anyShared = anyShared || is_shared(containers), 0)...};
+        (void)dummy;
+        if (anyShared)
+            return merged_arguments<ResultContainer>(
+                compare, std::true_type(), std::false_type(),
+                static_cast<const Containers &>(containers)...);
+        return merged_arguments<ResultContainer>(compare, IsLValue(), std::false_type(),
+                                                 containers...);
+    }
+} // namespace detail
+
+// -------------------- merged --------------------
+// Merges a container of sorted containers, like a std::vector<std::vector<int>>, into one
+// sorted container.
+template <typename Containers, typename Compare = std::less<ValueType<ValueType<Containers>>>,
+          typename = std::enable_if_t<
+              !std::is_same<remove_cvref_t<Containers>, remove_cvref_t<Compare>>::value>>
+auto merged(Containers &&containers, Compare &&compare = {})
+{
+    using IsLValue = typename std::is_lvalue_reference<Containers>::type;
+    using MayBeShared =
+        std::integral_constant<bool, detail::has_isDetached<remove_cvref_t<Containers>>::value
+                                         || detail::has_isDetached<ValueType<Containers>>::value>;
+    auto function = detail::to_function_object(std::forward<Compare>(compare));
+    return detail::merged_sources<remove_cvref_t<ValueType<Containers>>>(containers, function,
+                                                                         IsLValue(), MayBeShared());
+}
+
+// Merges two or more sorted containers of the same type into one sorted container, using
+// operator<. For other orders, use the container of containers version above.
+template <typename Container, typename... Containers,
+          typename = std::enable_if_t<
+              sizeof...(Containers) >= 1
+              && detail::all_true<std::is_same<remove_cvref_t<Container>,
+                                               remove_cvref_t<Containers>>::value...>::value>>
+auto merged(Container &&container, Containers &&...containers)
+{
+    // Only move items out, if all the containers are r-values, as the ranges must have the
+    // same type.
+    using IsLValue = std::integral_constant<
+        bool, !detail::all_true<!std::is_lvalue_reference<Container>::value,
+                                !std::is_lvalue_reference<Containers>::value...>::value>;
+    using MayBeShared = std::integral_constant<
+        bool, !IsLValue::value && detail::has_isDetached<remove_cvref_t<Container>>::value>;
+    std::less<ValueType<Container>> compare;
+    return detail::merged_arguments<remove_cvref_t<Container>>(compare, IsLValue(), MayBeShared(),
+                                                               container, containers...);
+}
+
+} // namespace kdalgorithms
@@ -12,6 +12,7 @@
 
 #include "is_detected.h"
 #include "shared.h"
+#include <functional>
 
 namespace kdalgorithms {
 
@@ -28,6 +29,48 @@ namespace detail {
 
         template <typename Item>
         using has_operator_lt = decltype(std::declval<Item>() < std::declval<Item>());
+
+        template <typename Container>
+        using has_key_type = typename Container::key_type;
+
+        template <typename Container>
+        using has_mapped_type = typename Container::mapped_type;
+
+        template <typename Container, typename Value>
+        using has_find = decltype(std::declval<const Container &>().find(std::declval<Value>()));
+
+        template <typename Container, typename Value>
+        using has_equal_range =
+            decltype(std::declval<const Container &>().equal_range(std::declval<Value>()));
+
+        template <typename Container, typename Pair>
+        using has_equal_range_on_key = decltype(std::declval<const Container &>().equal_range(
+            std::declval<Pair>().first));
+
+        template <typename Container, typename Value>
+        using has_remove = decltype(std::declval<Container &>().remove(std::declval<Value>()));
+
+        template <typename Container>
+        using has_data = decltype(std::declval<const Container &>().data());
+
+        template <typename Item>
+        using has_std_hash = decltype(std::hash<Item>()(std::declval<const Item &>()));
+
+        template <typename Map>
+        using has_key_comp = decltype(std::declval<const Map &>().key_comp());
+
+        template <typename Map>
+        using has_key_eq = decltype(std::declval<const Map &>().key_eq());
+
+        template <typename Map>
+        using has_extract =
+            decltype(std::declval<Map &>().extract(std::declval<typename Map::iterator>()));
+
+        template <typename Char>
+        using has_unicode = decltype(std::declval<const Char &>().unicode());
+
+        template <typename Container>
+        using has_isDetached = decltype(std::declval<const Container &>().isDetached());
     }
 
     template <typename Container>
@@ -46,5 +89,108 @@ namespace detail {
     template <typename Item>
     constexpr bool has_operator_lt_v = detail::is_detected_v<tests::has_operator_lt, Item>;
 
+    template <typename Item>
+    constexpr bool has_std_hash_v = detail::is_detected_v<tests::has_std_hash, Item>;
+
+    template <typename Container>
+    constexpr bool has_key_type_v = detail::is_detected_v<tests::has_key_type, Container>;
+
+    template <typename Container>
+    constexpr bool has_mapped_type_v = detail::is_detected_v<tests::has_mapped_type, Container>;
+
+    template <typename Container, typename Value>
+    constexpr bool has_find_v = detail::is_detected_v<tests::has_find, Container, Value>;
+
+    template <typename Container, typename Value>
+    using has_equal_range = detail::is_detected<tests::has_equal_range, Container, Value>;
+
+    template <typename Container, typename Pair>
+    constexpr bool has_equal_range_on_key_v =
+        detail::is_detected_v<tests::has_equal_range_on_key, Container, Pair>;
+
+    template <typename Container, typename Value>
+    using has_remove = detail::is_detected<tests::has_remove, Container, Value>;
+
+    // std::map and std::set, and their unordered versions have key_comp respectively key_eq
+    template <typename Map>
+    using has_key_comp = detail::is_detected<tests::has_key_comp, Map>;
+
+    template <typename Map>
+    using has_key_eq = detail::is_detected<tests::has_key_eq, Map>;
+
+    // The node handle API of the std maps and sets (C++17)
+    template <typename Map>
+    using has_extract = detail::is_detected<tests::has_extract, Map>;
+
+    // Implicitly shared Qt containers, which copy their items when a non-const method is called
+    // while the data is shared with another instance.
+    template <typename Container>
+    using has_isDetached = detail::is_detected<tests::has_isDetached, Container>;
+
+    // True for containers like std::vector, std::array, std::string, QVector and QByteArray,
+    // which store their items in one contiguous block of memory.
+    template <typename Container, typename = void>
+    struct is_contiguous : std::false_type
+    {
+    };
+
+    template <typename Container>
+    struct is_contiguous<Container, void_t<tests::has_data<Container>>>
+        : std::is_same<tests::has_data<Container>, const ValueType<Container> *>
+    {
+    };
+
+    template <typename Container>
+    constexpr bool is_contiguous_v = is_contiguous<Container>::value;
+
+    // The lookup of the std sets and maps compares keys by equivalence using their comparator,
+    // which is only the same as operator== for the default comparators. QSet uses operator==.
+    template <typename Container, typename = void, typename = void>
+    struct has_default_lookup : std::true_type
+    {
+    };
+
+    template <typename Container>
+    struct has_default_lookup<Container, void_t<typename Container::key_compare>, void>
+        : std::integral_constant<
+              bool,
+              std::is_same<typename Container::key_compare,
+                           std::less<typename Container::key_type>>::value
+                  || std::is_same<typename Container::key_compare, std::less<>>::value>
+    {
+    };
+
+    template <typename Container>
+    struct has_default_lookup<Container, void, void_t<typename Container::key_equal>>
+        : std::integral_constant<
+              bool,
+              std::is_same<typename Container::key_equal,
+                           std::equal_to<typename Container::key_type>>::value
+                  || std::is_same<typename Container::key_equal, std::equal_to<>>::value>
+    {
+    };
+
+    // Containers whose lookup compares with values of other types than the key type, rather
+    // than converting them to the key type first.
+    template <typename Container, typename = void, typename = void>
+    struct has_transparent_lookup : std::false_type
+    {
+    };
+
+    template <typename Container>
+    struct has_transparent_lookup<
+        Container, void_t<typename Container::key_compare::is_transparent>, void>
+        : std::true_type
+    {
+    };
+
+    template <typename Container>
+    struct has_transparent_lookup<Container, void,
+                                  void_t<typename Container::key_equal::is_transparent,
+                                         typename Container::hasher::is_transparent>>
+        : std::true_type
+    {
+    };
+
 } // namespace detail
 } // namespace kdalgorithms
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "find_if.h"
+#include "read_iterator_wrapper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    // Below this number of items per thread, starting a thread costs more than it saves, even
+    // for the expensive predicates the parallel searches are meant for.
+    constexpr std::size_t parallel_minimum_chunk_size = 32;
+
+    // The number of chunks to split size items into, with at least minimumChunkSize items in
+    // each chunk, and at most a chunk per CPU core.
+    inline std::size_t parallel_chunk_count(std::size_t size, std::size_t minimumChunkSize)
+    {
+        const std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        return std::max<std::size_t>(1, std::min(threads, size / minimumChunkSize));
+    }
+
+    // Calls function(first, last) for consecutive chunks of the indexes [0, size), each chunk
+    // in a thread of its own, with the last chunk being handled by the calling thread. Small
+    // sizes are handled by the calling thread alone.
+    // Exceptions thrown by function are rethrown once all the threads are done.
+    template <typename Function>
+    void parallel_for_chunks(std::size_t size, Function &&function,
+                             std::size_t minimumChunkSize = parallel_minimum_chunk_size)
+    {
+        const std::size_t chunks = parallel_chunk_count(size, minimumChunkSize);
+        if (chunks <= 1) {
+            if (size != 0)
+                function(std::size_t(0), size);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(chunks);
+        auto run = [&](std::size_t chunk) {
+            try {
+                function(chunk * size / chunks, (chunk + 1) * size / chunks);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(chunks - 1);
+        std::size_t chunk = 0;
+        try {
+            for (; chunk + 1 < chunks; ++chunk)
+                threads.emplace_back(run, chunk);
+        } catch (const std::system_error &) {
+            // Out of threads, the remaining chunks are handled by this thread.
+        }
+        for (; chunk < chunks; ++chunk)
+            run(chunk);
+
+        for (auto &thread : threads)
+            thread.join();
+        for (auto &error : errors) {
+            if (error)
+                std::rethrow_exception(error);
+        }
+    }
+
+    // Returns the index of the first item matching predicate, or size if there is none.
+    // As soon as a thread finds a match, the threads searching beyond it stop.
+    template <typename Iterator, typename UnaryPredicate>
+    std::size_t parallel_find_index(Iterator begin, std::size_t size, UnaryPredicate &predicate)
+    {
+        using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+        std::atomic<std::size_t> result(size);
+        parallel_for_chunks(size, [&](std::size_t first, std::size_t last) {
+            auto it = begin + static_cast<difference_type>(first);
+            for (std::size_t index = first; index < last; ++index, ++it) {
+                if (index >= result.load(std::memory_order_relaxed))
+                    return;
+                if (predicate(*it)) {
+                    auto current = result.load(std::memory_order_relaxed);
+                    while (index < current
+                           && !result.compare_exchange_weak(current, index,
+                                                            std::memory_order_relaxed)) {
+                    }
+                    return;
+                }
+            }
+        });
+        return result.load();
+    }
+
+    template <typename Iterator, typename UnaryPredicate>
+    Iterator parallel_find_if(Iterator begin, Iterator end, UnaryPredicate &predicate,
+                              std::random_access_iterator_tag)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        return std::next(begin, static_cast<std::ptrdiff_t>(
+                                    parallel_find_index(begin, size, predicate)));
+    }
+
+    // The range can't be split without walking it, so search it sequentially.
+    template <typename Iterator, typename UnaryPredicate>
+    Iterator parallel_find_if(Iterator begin, Iterator end, UnaryPredicate &predicate,
+                              std::input_iterator_tag)
+    {
+        return std::find_if(begin, end, predicate);
+    }
+
+    template <typename Iterator, typename UnaryPredicate>
+    Iterator parallel_find_if(Iterator begin, Iterator end, UnaryPredicate &predicate)
+    {
+        return parallel_find_if(begin, end, predicate,
+                                typename std::iterator_traits<Iterator>::iterator_category());
+    }
+} // namespace detail
+
+// -------------------- parallel_find_if --------------------
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+auto parallel_find_if(Container &&container, UnaryPredicate &&predicate)
+{
+    auto range = detail::find_if_iterator_wrapper(container);
+    auto function = detail::to_function_object(std::forward<UnaryPredicate>(predicate));
+    auto it = detail::parallel_find_if(range.begin(), range.end(), function);
+    using Iterator = decltype(range.begin());
+    return detail::create_result<Iterator>(std::move(it), range.begin(), range.end(),
+                                           std::is_lvalue_reference<Container>());
+}
+
+// -------------------- parallel_all_of / parallel_any_of / parallel_none_of --------------------
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+bool parallel_any_of(const Container &container, UnaryPredicate &&predicate)
+{
+    auto range = read_iterator_wrapper(container);
+    auto function = detail::to_function_object(std::forward<UnaryPredicate>(predicate));
+    return detail::parallel_find_if(range.begin(), range.end(), function) != range.end();
+}
+
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+bool parallel_all_of(const Container &container, UnaryPredicate &&predicate)
+{
+    auto range = read_iterator_wrapper(container);
+    auto function = detail::to_function_object(std::forward<UnaryPredicate>(predicate));
+    auto notFunction = [&function](const auto &value) { return !function(value); };
+    return detail::parallel_find_if(range.begin(), range.end(), notFunction) == range.end();
+}
+
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+bool parallel_none_of(const Container &container, UnaryPredicate &&predicate)
+{
+    return !parallel_any_of(container, std::forward<UnaryPredicate>(predicate));
+}
+
+} // namespace kdalgorithms
@@ -10,6 +10,7 @@
 
 #pragma once
 #include "method_tests.h"
+#include "shared.h"
 #include <iterator>
 #include <tuple>
 #include <type_traits>
@@ -41,6 +42,13 @@ namespace detail {
         return IteratorPair<Iterator>{begin, end};
     }
 
+    // Views refer to items owned by someone else, so even as r-values, their items must not be
+    // moved out.
+    template <typename Container>
+    struct is_view : std::false_type
+    {
+    };
+
     // used for l-value containers
     template <typename Container>
     auto read_iterator_wrapper_helper(const Container &container, std::true_type, std::false_type)
@@ -48,6 +56,58 @@ namespace detail {
         return make_iteratorPair(std::cbegin(container), std::cend(container));
     }
 
+    // Only true for implicitly shared Qt containers which share their data with another instance.
+    // Calling a non-const method on such a container makes a deep copy of it.
+    template <typename Container>
+    bool is_shared(const Container &container, std::true_type /*has_isDetached*/)
+    {
+        return !container.isDetached();
+    }
+
+    template <typename Container>
+    bool is_shared(const Container &, std::false_type /*has_isDetached*/)
+    {
+        return false;
+    }
+
+    template <typename Container>
+    bool is_shared(const Container &container)
+    {
+        return is_shared(container, has_isDetached<Container>());
+    }
+
+    // True for r-value implicitly shared containers, which share their data with another
+    // instance. Moving their items out would first detach them, i.e. copy all of the items, so
+    // the algorithms read them like const l-values instead.
+    template <typename Container>
+    bool is_shared_rvalue(const remove_cvref_t<Container> &container)
+    {
+        return !std::is_lvalue_reference<Container>::value && is_shared(container);
+    }
+
+    // The container to use in the is_shared_rvalue branch, which reads it as a const l-value.
+    // Containers without isDetached never take that branch, so they are passed on unchanged, to
+    // avoid instantiating the l-value code path, which fails for items that can't be copied.
+    template <typename Container>
+    decltype(auto) shared_input(std::remove_reference_t<Container> &container,
+                                std::true_type /*has_isDetached*/)
+    {
+        return static_cast<const remove_cvref_t<Container> &>(container);
+    }
+
+    template <typename Container>
+    decltype(auto) shared_input(std::remove_reference_t<Container> &container,
+                                std::false_type /*has_isDetached*/)
+    {
+        return static_cast<Container &&>(container);
+    }
+
+    template <typename Container>
+    decltype(auto) shared_input(std::remove_reference_t<Container> &container)
+    {
+        return shared_input<Container>(container, has_isDetached<remove_cvref_t<Container>>());
+    }
+
     // used for r-value containers
     template <typename Container>
     auto read_iterator_wrapper_helper(Container &&container, std::false_type, std::false_type)
@@ -70,7 +130,9 @@ template <typename Container>
 auto read_iterator_wrapper(Container &&container)
 {
     return detail::read_iterator_wrapper_helper(
-        std::forward<Container>(container), typename std::is_lvalue_reference<Container>::type(),
+        std::forward<Container>(container),
+        std::integral_constant<bool, std::is_lvalue_reference<Container>::value
+                                         || detail::is_view<remove_cvref_t<Container>>::value>(),
         detail::has_keyValueBegin<Container>());
 }
 } // namespace kdalgorithms
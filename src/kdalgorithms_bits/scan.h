@@ -0,0 +1,307 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "parallel.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include "transform.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    // Writes initialValue, op(initialValue, x0), op(op(initialValue, x0), x1), ... to out.
+    // Each item is read before out is written, so out may be the same as first.
+    template <typename InputIterator, typename OutputIterator, typename T, typename BinaryOperation>
+    void exclusive_scan_range(InputIterator first, InputIterator last, OutputIterator out,
+                              T initialValue, BinaryOperation &op)
+    {
+        for (; first != last; ++first, ++out) {
+            T next = op(initialValue, *first);
+            *out = std::move(initialValue);
+            initialValue = std::move(next);
+        }
+    }
+
+    template <typename Iterator, typename T, typename BinaryOperation>
+    void inclusive_scan_from(Iterator first, Iterator last, const T *carry, BinaryOperation &op)
+    {
+        if (!carry) {
+            std::partial_sum(first, last, first, op);
+            return;
+        }
+        T running = *carry;
+        for (; first != last; ++first) {
+            running = op(running, *first);
+            *first = running;
+        }
+    }
+
+    template <typename Container>
+    auto scan_input(Container &container, std::true_type /*is_lvalue_reference*/)
+    {
+        return std::make_pair(std::cbegin(container), std::cend(container));
+    }
+
+    // Items of r-value containers are moved into the operation.
+    template <typename Container>
+    auto scan_input(Container &container, std::false_type /*is_lvalue_reference*/)
+    {
+        return std::make_pair(std::make_move_iterator(std::begin(container)),
+                              std::make_move_iterator(std::end(container)));
+    }
+
+    // Below this number of items per thread, the extra pass costs more than the threads save.
+    constexpr std::size_t parallel_scan_minimum_chunk_size = 16384;
+
+    // Scans the range in place in two passes: first each chunk but the last is reduced, then each
+    // chunk is scanned starting from the combined reductions of the chunks before it.
+    // initialValue is nullptr for an inclusive scan.
+    template <typename Iterator, typename T, typename BinaryOperation>
+    void parallel_scan(Iterator begin, Iterator end, const T *initialValue, BinaryOperation &op,
+                       std::random_access_iterator_tag)
+    {
+        const auto size = static_cast<std::size_t>(std::distance(begin, end));
+        if (size == 0)
+            return;
+        const std::size_t chunks = parallel_chunk_count(size, parallel_scan_minimum_chunk_size);
+        auto chunkBegin = [&](std::size_t chunk) {
+            return begin + static_cast<std::ptrdiff_t>(chunk * size / chunks);
+        };
+        auto scanChunk = [&](std::size_t chunk, const T *carry) {
+            if (initialValue)
+                exclusive_scan_range(chunkBegin(chunk), chunkBegin(chunk + 1), chunkBegin(chunk),
+                                     *carry, op);
+            else
+                inclusive_scan_from(chunkBegin(chunk), chunkBegin(chunk + 1), carry, op);
+        };
+        if (chunks <= 1) {
+            scanChunk(0, initialValue);
+            return;
+        }
+
+        // Up-sweep: reduce each chunk but the last. A thread may be given several chunks, as
+        // parallel_for_chunks splits the work independently of the chunks used here. Each chunk
+        // is large already, so parallel_for_chunks is told that one chunk is worth a thread.
+        std::vector<std::unique_ptr<T>> carries(chunks);
+        auto reduceChunks = [&](std::size_t firstChunk, std::size_t lastChunk) {
+            for (auto chunk = firstChunk; chunk < lastChunk; ++chunk) {
+                auto first = chunkBegin(chunk);
+                T reduced = *first;
+                carries[chunk + 1] = std::make_unique<T>(std::accumulate(
+                    std::next(first), chunkBegin(chunk + 1), std::move(reduced), op));
+            }
+        };
+        parallel_for_chunks(chunks - 1, reduceChunks, 1);
+
+        // Combine the reductions, so each chunk knows what comes before it.
+        if (initialValue)
+            carries[0] = std::make_unique<T>(*initialValue);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+            if (carries[chunk - 1])
+                *carries[chunk] = op(*carries[chunk - 1], *carries[chunk]);
+        }
+
+        // Down-sweep: scan each chunk, starting from its carry.
+        auto scanChunks = [&](std::size_t firstChunk, std::size_t lastChunk) {
+            for (auto chunk = firstChunk; chunk < lastChunk; ++chunk)
+                scanChunk(chunk, carries[chunk].get());
+        };
+        parallel_for_chunks(chunks, scanChunks, 1);
+    }
+
+    // The range can't be split without walking it, so scan it sequentially.
+    template <typename Iterator, typename T, typename BinaryOperation>
+    void parallel_scan(Iterator begin, Iterator end, const T *initialValue, BinaryOperation &op,
+                       std::forward_iterator_tag)
+    {
+        if (initialValue)
+            exclusive_scan_range(begin, end, begin, *initialValue, op);
+        else
+            std::partial_sum(begin, end, begin, op);
+    }
+
+    template <typename Container, typename T, typename BinaryOperation>
+    void parallel_scan(Container &container, const T *initialValue, BinaryOperation &op)
+    {
+        using Iterator = decltype(std::begin(container));
+        parallel_scan(std::begin(container), std::end(container), initialValue, op,
+                      typename std::iterator_traits<Iterator>::iterator_category());
+    }
+
+    template <typename Container, typename Projection>
+    using ProjectedType =
+        remove_cvref_t<detail::invoke_result_t<Projection, ValueType<Container>>>;
+} // namespace detail
+
+// -------------------- inclusive_scan / exclusive_scan --------------------
+// In place prefix sums: inclusive_scan replaces each item with the sum of itself and all the
+// items before it, exclusive_scan with the sum of initialValue and the items before it.
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+void inclusive_scan(Container &container, BinaryOperation &&op = {})
+{
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    std::partial_sum(std::begin(container), std::end(container), std::begin(container), function);
+}
+
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>,
+          typename T = ValueType<Container>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, T, ValueType<Container>>
+#endif
+void exclusive_scan(Container &container, BinaryOperation &&op = {}, T initialValue = {})
+{
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    detail::exclusive_scan_range(std::begin(container), std::end(container),
+                                 std::begin(container), std::move(initialValue), function);
+}
+
+// -------------------- inclusive_scanned / exclusive_scanned --------------------
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+remove_cvref_t<Container> inclusive_scanned(Container &&container, BinaryOperation &&op = {})
+{
+    if (detail::is_shared_rvalue<Container>(container))
+        return inclusive_scanned(detail::shared_input<Container>(container),
+                                 std::forward<BinaryOperation>(op));
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    auto input = detail::scan_input(container, std::is_lvalue_reference<Container>());
+    remove_cvref_t<Container> result;
+    detail::reserve(result, container.size());
+    std::partial_sum(input.first, input.second, detail::insert_wrapper(result), function);
+    return result;
+}
+
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>,
+          typename T = ValueType<Container>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, T, ValueType<Container>>
+#endif
+remove_cvref_t<Container> exclusive_scanned(Container &&container, BinaryOperation &&op = {},
+                                            T initialValue = {})
+{
+    if (detail::is_shared_rvalue<Container>(container))
+        return exclusive_scanned(detail::shared_input<Container>(container),
+                                 std::forward<BinaryOperation>(op), std::move(initialValue));
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    auto input = detail::scan_input(container, std::is_lvalue_reference<Container>());
+    remove_cvref_t<Container> result;
+    detail::reserve(result, container.size());
+    detail::exclusive_scan_range(input.first, input.second, detail::insert_wrapper(result),
+                                 std::move(initialValue), function);
+    return result;
+}
+
+// -------------------- inclusive_scanned_by / exclusive_scanned_by --------------------
+// Scans the values of projection(item), e.g. exclusive_scanned_by(records, &Record::size) gives
+// the offset of each record.
+template <typename Container, typename Projection,
+          typename BinaryOperation = std::plus<detail::ProjectedType<Container, Projection>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Projection, ValueType<Container>>
+#endif
+auto inclusive_scanned_by(Container &&container, Projection &&projection,
+                          BinaryOperation &&op = {})
+{
+    auto result = kdalgorithms::transformed(std::forward<Container>(container),
+                                            std::forward<Projection>(projection));
+    kdalgorithms::inclusive_scan(result, std::forward<BinaryOperation>(op));
+    return result;
+}
+
+template <typename Container, typename Projection,
+          typename BinaryOperation = std::plus<detail::ProjectedType<Container, Projection>>,
+          typename T = detail::ProjectedType<Container, Projection>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Projection, ValueType<Container>>
+#endif
+auto exclusive_scanned_by(Container &&container, Projection &&projection,
+                          BinaryOperation &&op = {}, T initialValue = {})
+{
+    auto result = kdalgorithms::transformed(std::forward<Container>(container),
+                                            std::forward<Projection>(projection));
+    kdalgorithms::exclusive_scan(result, std::forward<BinaryOperation>(op),
+                                 std::move(initialValue));
+    return result;
+}
+
+// -------------------- parallel_inclusive_scan / parallel_exclusive_scan --------------------
+// Like inclusive_scan and exclusive_scan, but splits containers with random access iterators
+// between threads. op must be associative, as the items are combined in a different grouping.
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+void parallel_inclusive_scan(Container &container, BinaryOperation &&op = {})
+{
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    detail::parallel_scan(container, static_cast<const ValueType<Container> *>(nullptr), function);
+}
+
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+void parallel_exclusive_scan(Container &container, BinaryOperation &&op = {},
+                             ValueType<Container> initialValue = {})
+{
+    auto function = detail::to_function_object(std::forward<BinaryOperation>(op));
+    detail::parallel_scan(container, &initialValue, function);
+}
+
+// -------------------- parallel_inclusive_scanned / parallel_exclusive_scanned ---------------
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+auto parallel_inclusive_scanned(Container &&container, BinaryOperation &&op = {})
+{
+    remove_cvref_t<Container> result(std::forward<Container>(container));
+    kdalgorithms::parallel_inclusive_scan(result, std::forward<BinaryOperation>(op));
+    return result;
+}
+
+template <typename Container, typename BinaryOperation = std::plus<ValueType<Container>>>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<Container>, BinaryOperation, ValueType<Container>,
+                                   ValueType<Container>>
+#endif
+auto parallel_exclusive_scanned(Container &&container, BinaryOperation &&op = {},
+                                ValueType<Container> initialValue = {})
+{
+    remove_cvref_t<Container> result(std::forward<Container>(container));
+    kdalgorithms::parallel_exclusive_scan(result, std::forward<BinaryOperation>(op),
+                                          std::move(initialValue));
+    return result;
+}
+
+} // namespace kdalgorithms
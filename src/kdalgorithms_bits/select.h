@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+// Selections of items, as indexes or as a mask, which can be computed once from one container,
+// and then applied to several others of the same size, e.g. the columns of a table stored as
+// one container per column.
+
+namespace kdalgorithms {
+
+// -------------------- select_indices / select_mask --------------------
+// The indexes of the items matching predicate, in increasing order. The indexes are written
+// without branching on the result of the predicate, like compact_branchless does for filter.
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+std::vector<std::size_t> select_indices(const Container &container, UnaryPredicate &&predicate)
+{
+    auto &&function = detail::to_function_object(std::forward<UnaryPredicate>(predicate));
+    std::vector<std::size_t> result(static_cast<std::size_t>(container.size()));
+    std::size_t count = 0;
+    std::size_t index = 0;
+    for (const auto &item : container) {
+        result[count] = index++;
+        count += static_cast<bool>(function(item));
+    }
+    result.resize(count);
+    return result;
+}
+
+// A mask with one bit per item, which is set for the items matching predicate.
+template <typename Container, typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires UnaryPredicateOnContainerValues<UnaryPredicate, Container>
+#endif
+std::vector<bool> select_mask(const Container &container, UnaryPredicate &&predicate)
+{
+    auto &&function = detail::to_function_object(std::forward<UnaryPredicate>(predicate));
+    std::vector<bool> result;
+    result.reserve(static_cast<std::size_t>(container.size()));
+    for (const auto &item : container)
+        result.push_back(static_cast<bool>(function(item)));
+    return result;
+}
+
+// -------------------- gather / apply_mask --------------------
+// The items at the given indexes of a random access container, in the order of indexes.
+template <typename Container, typename Indices>
+auto gather(const Container &container, const Indices &indices)
+{
+    using Iterator = decltype(std::begin(container));
+    using Category = typename std::iterator_traits<Iterator>::iterator_category;
+    static_assert(std::is_base_of<std::random_access_iterator_tag, Category>::value,
+                  "gather requires a container with random access iterators");
+
+    Container result;
+    detail::reserve(result, static_cast<typename Container::size_type>(indices.size()));
+    auto inserter = detail::insert_wrapper(result);
+    const auto begin = std::begin(container);
+    for (auto index : indices) {
+        assert(static_cast<std::size_t>(index) < static_cast<std::size_t>(container.size()));
+        *inserter = begin[static_cast<std::ptrdiff_t>(index)];
+        ++inserter;
+    }
+    return result;
+}
+
+// The items for which the mask is set. The mask must have the same size as the container. Items
+// are moved out of r-value containers.
+template <typename Container, typename Mask>
+remove_cvref_t<Container> apply_mask(Container &&container, const Mask &mask)
+{
+    assert(static_cast<std::size_t>(mask.size()) == static_cast<std::size_t>(container.size()));
+    if (detail::is_shared_rvalue<Container>(container))
+        return apply_mask(detail::shared_input<Container>(container), mask);
+
+    remove_cvref_t<Container> result;
+    auto inserter = detail::insert_wrapper(result);
+    auto selected = std::begin(mask);
+    auto range = read_iterator_wrapper(std::forward<Container>(container));
+    for (auto it = range.begin(); it != range.end(); ++it, ++selected) {
+        if (*selected) {
+            *inserter = *it;
+            ++inserter;
+        }
+    }
+    return result;
+}
+
+} // namespace kdalgorithms
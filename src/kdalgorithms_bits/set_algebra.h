@@ -0,0 +1,354 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "insert_wrapper.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    // Galloping is only worth it when one range is much larger than the other, otherwise the
+    // extra comparisons cost more than they save.
+    constexpr std::size_t gallop_size_ratio = 16;
+
+    // Returns the first item in [first, last) not less than value. The range is searched in
+    // steps of 1, 2, 4, ... from first, followed by a binary search in the last step, so the
+    // cost is logarithmic in the distance to the result, rather than in the size of the range.
+    template <typename Iterator, typename Value, typename Compare>
+    Iterator gallop_lower_bound(Iterator first, Iterator last, const Value &value,
+                                Compare &compare)
+    {
+        typename std::iterator_traits<Iterator>::difference_type step = 1;
+        while (last - first > step && compare(first[step], value)) {
+            first += step;
+            step *= 2;
+        }
+        return std::lower_bound(first, std::min(first + step, last), value, compare);
+    }
+
+    template <typename Iterator, typename Value, typename Compare>
+    Iterator skip_less(Iterator first, Iterator last, const Value &value, Compare &compare,
+                       bool gallop)
+    {
+        if (gallop)
+            return gallop_lower_bound(first, last, value, compare);
+        ++first;
+        while (first != last && compare(*first, value))
+            ++first;
+        return first;
+    }
+
+    // Which items a set operation keeps: those only in the first range, those only in the second
+    // range, and those in both.
+    struct set_operation
+    {
+        bool onlyFirst;
+        bool onlySecond;
+        bool both;
+    };
+
+    constexpr set_operation set_union_operation{true, true, true};
+    constexpr set_operation set_intersection_operation{false, false, true};
+    constexpr set_operation set_difference_operation{true, false, false};
+    constexpr set_operation set_symmetric_difference_operation{true, true, false};
+
+    template <typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare>
+    void set_algorithm(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                       OutputIterator out, Compare &compare, set_operation operation,
+                       std::random_access_iterator_tag)
+    {
+        const auto size1 = static_cast<std::size_t>(last1 - first1);
+        const auto size2 = static_cast<std::size_t>(last2 - first2);
+        const bool gallop1 = size1 >= gallop_size_ratio * size2;
+        const bool gallop2 = size2 >= gallop_size_ratio * size1;
+
+        while (first1 != last1 && first2 != last2) {
+            if (compare(*first1, *first2)) {
+                auto next = skip_less(first1, last1, *first2, compare, gallop1);
+                if (operation.onlyFirst)
+                    out = std::copy(first1, next, out);
+                first1 = next;
+            } else if (compare(*first2, *first1)) {
+                auto next = skip_less(first2, last2, *first1, compare, gallop2);
+                if (operation.onlySecond)
+                    out = std::copy(first2, next, out);
+                first2 = next;
+            } else {
+                if (operation.both) {
+                    *out = *first1;
+                    ++out;
+                }
+                ++first1;
+                ++first2;
+            }
+        }
+        if (operation.onlyFirst)
+            out = std::copy(first1, last1, out);
+        if (operation.onlySecond)
+            std::copy(first2, last2, out);
+    }
+
+    // Without random access iterators, there is no way to skip ahead, so do the plain merge.
+    template <typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare>
+    void set_algorithm(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2,
+                       OutputIterator out, Compare &compare, set_operation operation,
+                       std::input_iterator_tag)
+    {
+        if (operation.both && operation.onlyFirst)
+            std::set_union(first1, last1, first2, last2, out, compare);
+        else if (operation.both)
+            std::set_intersection(first1, last1, first2, last2, out, compare);
+        else if (operation.onlySecond)
+            std::set_symmetric_difference(first1, last1, first2, last2, out, compare);
+        else
+            std::set_difference(first1, last1, first2, last2, out, compare);
+    }
+
+    // The largest possible size of the result
+    template <typename Size1, typename Size2>
+    std::size_t set_result_size(Size1 size1, Size2 size2, set_operation operation)
+    {
+        const auto first = static_cast<std::size_t>(size1);
+        const auto second = static_cast<std::size_t>(size2);
+        if (operation.onlySecond)
+            return first + second;
+        if (operation.onlyFirst)
+            return first;
+        return std::min(first, second);
+    }
+
+    template <typename Iterator1, typename Iterator2>
+    using common_iterator_category_t = std::conditional_t<
+        std::is_base_of<std::random_access_iterator_tag,
+                        typename std::iterator_traits<Iterator1>::iterator_category>::value
+            && std::is_base_of<std::random_access_iterator_tag,
+                               typename std::iterator_traits<Iterator2>::iterator_category>::value,
+        std::random_access_iterator_tag, std::input_iterator_tag>;
+
+    template <typename ResultContainer, typename Container1, typename Container2,
+              typename Compare>
+    ResultContainer set_algorithm(Container1 &&container1, Container2 &&container2,
+                                  Compare &&compare, set_operation operation)
+    {
+        if (is_shared_rvalue<Container1>(container1))
+            return set_algorithm<ResultContainer>(shared_input<Container1>(container1),
+                                                  std::forward<Container2>(container2),
+                                                  std::forward<Compare>(compare), operation);
+        if (is_shared_rvalue<Container2>(container2))
+            return set_algorithm<ResultContainer>(std::forward<Container1>(container1),
+                                                  shared_input<Container2>(container2),
+                                                  std::forward<Compare>(compare), operation);
+        ResultContainer result;
+        detail::reserve(result, set_result_size(container1.size(), container2.size(), operation));
+
+        auto range1 = read_iterator_wrapper(std::forward<Container1>(container1));
+        auto range2 = read_iterator_wrapper(std::forward<Container2>(container2));
+        using Category = common_iterator_category_t<decltype(range1.begin()),
+                                                    decltype(range2.begin())>;
+        set_algorithm(range1.begin(), range1.end(), range2.begin(), range2.end(),
+                      detail::insert_wrapper(result), compare, operation, Category());
+        return result;
+    }
+
+    // Returns, for each item of container1, whether it is left over, when each item of
+    // container2 has been matched with an equal item of container1.
+    template <typename Container1, typename Container2>
+    std::vector<char> unmatched_items(const Container1 &container1, const Container2 &container2)
+    {
+        using T = ValueType<Container1>;
+        static_assert(std::is_same<T, ValueType<Container2>>::value,
+                      "The containers must have the same value type");
+        auto hash = [](const T *item) { return std::hash<T>()(*item); };
+        auto equal = [](const T *x, const T *y) { return *x == *y; };
+        std::unordered_map<const T *, std::size_t, decltype(hash), decltype(equal)> counts(
+            container2.size(), hash, equal);
+        for (const auto &item : container2)
+            ++counts[std::addressof(item)];
+
+        std::vector<char> result;
+        result.reserve(container1.size());
+        for (const auto &item : container1) {
+            auto it = counts.find(std::addressof(item));
+            const bool unmatched = it == counts.end() || it->second == 0;
+            if (!unmatched)
+                --it->second;
+            result.push_back(unmatched);
+        }
+        return result;
+    }
+
+    template <typename ResultContainer, typename Container>
+    void append_flagged(ResultContainer &result, Container &&container,
+                        const std::vector<char> &flags)
+    {
+        if (is_shared_rvalue<Container>(container)) {
+            append_flagged(result, shared_input<Container>(container), flags);
+            return;
+        }
+        auto inserter = detail::insert_wrapper(result);
+        auto range = read_iterator_wrapper(std::forward<Container>(container));
+        std::size_t index = 0;
+        for (auto it = range.begin(); it != range.end(); ++it, ++index) {
+            if (flags[index]) {
+                *inserter = *it;
+                ++inserter;
+            }
+        }
+    }
+
+    inline std::vector<char> inverted(std::vector<char> flags)
+    {
+        for (auto &flag : flags)
+            flag = !flag;
+        return flags;
+    }
+} // namespace detail
+
+// -------------------- set_union / set_intersection / set_difference / ... --------------------
+// The containers must be sorted according to compare.
+template <typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_union(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<remove_cvref_t<Container1>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_union_operation);
+}
+
+template <template <typename...> class ResultContainer, typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_union(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<ResultContainer<ValueType<Container1>>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_union_operation);
+}
+
+template <typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_intersection(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<remove_cvref_t<Container1>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_intersection_operation);
+}
+
+template <template <typename...> class ResultContainer, typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_intersection(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<ResultContainer<ValueType<Container1>>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_intersection_operation);
+}
+
+template <typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_difference(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<remove_cvref_t<Container1>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_difference_operation);
+}
+
+template <template <typename...> class ResultContainer, typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_difference(Container1 &&container1, Container2 &&container2, Compare &&compare = {})
+{
+    return detail::set_algorithm<ResultContainer<ValueType<Container1>>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_difference_operation);
+}
+
+template <typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_symmetric_difference(Container1 &&container1, Container2 &&container2,
+                              Compare &&compare = {})
+{
+    return detail::set_algorithm<remove_cvref_t<Container1>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_symmetric_difference_operation);
+}
+
+template <template <typename...> class ResultContainer, typename Container1, typename Container2,
+          typename Compare = std::less<ValueType<Container1>>>
+auto set_symmetric_difference(Container1 &&container1, Container2 &&container2,
+                              Compare &&compare = {})
+{
+    return detail::set_algorithm<ResultContainer<ValueType<Container1>>>(
+        std::forward<Container1>(container1), std::forward<Container2>(container2),
+        detail::to_function_object(std::forward<Compare>(compare)),
+        detail::set_symmetric_difference_operation);
+}
+
+// -------------------- set_union_unordered / set_intersection_unordered / ... ------------
+// Versions for containers which aren't sorted, using std::hash and operator== on the items.
+// Items are kept in the order of the input containers.
+template <typename Container1, typename Container2>
+auto set_union_unordered(Container1 &&container1, Container2 &&container2)
+{
+    const std::vector<char> flags1(container1.size(), true);
+    auto flags2 = detail::unmatched_items(container2, container1);
+    remove_cvref_t<Container1> result;
+    detail::reserve(result, container1.size() + container2.size());
+    detail::append_flagged(result, std::forward<Container1>(container1), flags1);
+    detail::append_flagged(result, std::forward<Container2>(container2), flags2);
+    return result;
+}
+
+template <typename Container1, typename Container2>
+auto set_intersection_unordered(Container1 &&container1, const Container2 &container2)
+{
+    auto flags = detail::inverted(detail::unmatched_items(container1, container2));
+    remove_cvref_t<Container1> result;
+    detail::append_flagged(result, std::forward<Container1>(container1), flags);
+    return result;
+}
+
+template <typename Container1, typename Container2>
+auto set_difference_unordered(Container1 &&container1, const Container2 &container2)
+{
+    auto flags = detail::unmatched_items(container1, container2);
+    remove_cvref_t<Container1> result;
+    detail::append_flagged(result, std::forward<Container1>(container1), flags);
+    return result;
+}
+
+template <typename Container1, typename Container2>
+auto set_symmetric_difference_unordered(Container1 &&container1, Container2 &&container2)
+{
+    auto flags1 = detail::unmatched_items(container1, container2);
+    auto flags2 = detail::unmatched_items(container2, container1);
+    remove_cvref_t<Container1> result;
+    detail::append_flagged(result, std::forward<Container1>(container1), flags1);
+    detail::append_flagged(result, std::forward<Container2>(container2), flags2);
+    return result;
+}
+
+} // namespace kdalgorithms
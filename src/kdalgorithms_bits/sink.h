@@ -0,0 +1,93 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "is_detected.h"
+#include "shared.h"
+#include "to_function_object.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace kdalgorithms {
+namespace detail {
+    template <typename T>
+    using has_iterator_category = typename std::iterator_traits<T>::iterator_category;
+
+    // Before C++20, std::iterator_traits also gives pointers to functions an iterator_category.
+    template <typename Sink>
+    using is_sink_iterator =
+        std::integral_constant<bool, is_detected_v<has_iterator_category, Sink>
+                                         && !std::is_function<std::remove_pointer_t<Sink>>::value>;
+
+    // An output iterator, which hands each item written to it on to the sink: either a callable,
+    // which is called with the item, or an output iterator, which the item is written to.
+    // Pointers to member functions are wrapped by to_function_object.
+    template <typename Sink>
+    class sink_iterator
+    {
+        using IsIterator = is_sink_iterator<Sink>;
+        using StoredSink = remove_cvref_t<decltype(to_function_object(std::declval<Sink>()))>;
+
+    public:
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        explicit sink_iterator(Sink sink)
+            : m_sink(to_function_object(std::move(sink)))
+        {
+        }
+
+        sink_iterator &operator*() { return *this; }
+        sink_iterator &operator++() { return *this; }
+        sink_iterator &operator++(int) { return *this; }
+
+        template <typename T, typename = std::enable_if_t<
+                                  !std::is_same<remove_cvref_t<T>, sink_iterator>::value>>
+        sink_iterator &operator=(T &&item)
+        {
+            put(std::forward<T>(item), IsIterator());
+            return *this;
+        }
+
+    private:
+        template <typename T>
+        void put(T &&item, std::false_type /*is iterator*/)
+        {
+            m_sink(std::forward<T>(item));
+        }
+
+        template <typename T>
+        void put(T &&item, std::true_type /*is iterator*/)
+        {
+            *m_sink = std::forward<T>(item);
+            ++m_sink;
+        }
+
+        StoredSink m_sink;
+    };
+} // namespace detail
+
+// -------------------- to_sink --------------------
+// Makes transformed, filtered, zip, cartesian_product and multi_partitioned hand over their
+// results one by one, rather than collecting them in a container. sink is either a callable,
+// which is called with each result, or an output iterator, which the results are written to.
+template <typename Sink>
+auto to_sink(Sink &&sink)
+{
+    return detail::sink_iterator<std::decay_t<Sink>>(std::forward<Sink>(sink));
+}
+
+} // namespace kdalgorithms
@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "contiguous_search.h"
+#include "is_detected.h"
+#include <cstddef>
+#include <utility>
+
+namespace kdalgorithms {
+
+// A set of constants, which is sorted at compile time, and searched using a branch free
+// binary search. As the size is known at compile time, the compiler can unroll the search
+// completely, so a lookup is just a handful of comparisons and conditional moves.
+// Duplicate values are kept, so iterating the set gives them more than once, while count, like
+// for other sets, counts each value once.
+template <typename T, std::size_t N>
+class static_set
+{
+    static_assert(N > 0, "a static_set must contain at least one value");
+
+public:
+    using key_type = T;
+    using value_type = T;
+    using size_type = std::size_t;
+    using const_iterator = const T *;
+    using iterator = const_iterator;
+
+    constexpr explicit static_set(const T (&values)[N])
+        : m_values{}
+    {
+        for (std::size_t i = 0; i < N; ++i)
+            m_values[i] = values[i];
+
+        // Insertion sort, as std::sort isn't constexpr before C++20
+        for (std::size_t i = 1; i < N; ++i) {
+            for (std::size_t j = i; j > 0 && m_values[j] < m_values[j - 1]; --j) {
+                T tmp = m_values[j];
+                m_values[j] = m_values[j - 1];
+                m_values[j - 1] = tmp;
+            }
+        }
+    }
+
+    // As for kdalgorithms::contains on a std::set, a value which can't be represented in T, like
+    // 3.5 for a set of ints, isn't found, rather than converted to T.
+    template <typename Value>
+    constexpr const_iterator find(const Value &value) const
+    {
+        return detail::is_valid_key<static_set>(value) ? search(value) : end();
+    }
+
+    template <typename Value>
+    constexpr bool contains(const Value &value) const
+    {
+        return find(value) != end();
+    }
+
+    constexpr const_iterator begin() const { return m_values; }
+    constexpr const_iterator end() const { return m_values + N; }
+    constexpr size_type size() const { return N; }
+
+private:
+    constexpr const_iterator search(const T &value) const
+    {
+        const T *base = m_values;
+        std::size_t length = N;
+        while (length > 1) {
+            const std::size_t half = length / 2;
+            base = base[half] < value ? base + half : base;
+            length -= half;
+        }
+        const T *lowerBound = base + (*base < value);
+        return lowerBound != end() && !(value < *lowerBound) ? lowerBound : end();
+    }
+
+    T m_values[N];
+};
+
+namespace detail {
+    template <typename T, typename Value>
+    using braced_conversion = decltype(T{std::declval<Value>()});
+}
+
+template <typename T, typename... Values>
+constexpr auto make_static_set(T value, Values... values)
+{
+    // Some compilers only warn about narrowing in the brace initialization below
+    static_assert(
+        std::is_same<
+            std::integer_sequence<bool, true,
+                                  detail::is_detected_v<detail::braced_conversion, T, Values>...>,
+            std::integer_sequence<bool, detail::is_detected_v<detail::braced_conversion, T,
+                                                              Values>...,
+                                  true>>::value,
+        "The values must convert to the type of the first value without narrowing");
+    const T array[] = {value, values...};
+    return static_set<T, 1 + sizeof...(Values)>(array);
+}
+
+} // namespace kdalgorithms
@@ -0,0 +1,67 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "read_iterator_wrapper.h"
+#include "shared.h"
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace kdalgorithms {
+
+// A pair of iterators into a container, which can be given to the algorithms as if it was a
+// container. It doesn't own the items, so they are never moved out of it.
+template <typename Iterator>
+class subrange
+{
+public:
+    using iterator = Iterator;
+    using const_iterator = Iterator;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using reference = typename std::iterator_traits<Iterator>::reference;
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    using size_type = std::size_t;
+
+    subrange() = default;
+    subrange(Iterator begin, Iterator end)
+        : m_begin(std::move(begin))
+        , m_end(std::move(end))
+    {
+    }
+
+    Iterator begin() const { return m_begin; }
+    Iterator end() const { return m_end; }
+    size_type size() const { return static_cast<size_type>(std::distance(m_begin, m_end)); }
+    bool empty() const { return m_begin == m_end; }
+
+    reference front() const { return *m_begin; }
+    reference operator[](difference_type index) const { return m_begin[index]; }
+
+private:
+    Iterator m_begin;
+    Iterator m_end;
+};
+
+template <typename Iterator>
+subrange<Iterator> make_subrange(Iterator begin, Iterator end)
+{
+    return {std::move(begin), std::move(end)};
+}
+
+namespace detail {
+    template <typename Iterator>
+    struct is_view<subrange<Iterator>> : std::true_type
+    {
+    };
+}
+
+} // namespace kdalgorithms
@@ -11,11 +11,19 @@
 #pragma once
 
 #include "insert_wrapper.h"
+#include "invoke.h"
 #include "read_iterator_wrapper.h"
 #include "reserve_helper.h"
 #include "shared.h"
+#include "sink.h"
 #include "to_function_object.h"
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace kdalgorithms {
 namespace detail {
@@ -42,6 +50,10 @@ namespace detail {
     template <typename ResultContainer, typename InputContainer, typename Transform>
     ResultContainer transformed(InputContainer &&input, Transform &&transform, std::true_type)
     {
+        if (is_shared_rvalue<InputContainer>(input))
+            return transformed<ResultContainer>(
+                shared_input<InputContainer>(input),
+                std::forward<Transform>(transform), std::true_type());
         ResultContainer result;
         detail::reserve(result, input.size());
         auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
@@ -51,11 +63,15 @@ namespace detail {
     }
 
     // optimized version to use for r-values where container type is the same
-    // in-place editing is possible in that case.
+    // in-place editing is possible in that case, unless the container is shared (see is_shared).
     template <typename ResultContainer, typename InputContainer, typename Transform>
     ResultContainer transformed(InputContainer &&input, Transform &&transform,
                                 std::false_type /* r-value and same containers */)
     {
+        if (is_shared(input))
+            return transformed<ResultContainer>(shared_input<InputContainer>(input),
+                                                std::forward<Transform>(transform),
+                                                std::true_type());
         std::transform(std::begin(input), std::end(input), std::begin(input),
                        std::forward<Transform>(transform));
         return std::forward<InputContainer>(input);
@@ -111,6 +127,24 @@ auto transformed(InputContainer &&input, Transform &&transform)
         detail::to_function_object(std::forward<Transform>(transform)));
 }
 
+// Hands the transformed items to sink (see to_sink) one by one, rather than returning them in a
+// container.
+template <typename InputContainer, typename Transform, typename Sink>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Transform, ValueType<InputContainer>>
+#endif
+void transformed(InputContainer &&input, Transform &&transform, detail::sink_iterator<Sink> sink)
+{
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        transformed(detail::shared_input<InputContainer>(input),
+                    std::forward<Transform>(transform), std::move(sink));
+        return;
+    }
+    auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+    std::transform(range.begin(), range.end(), std::move(sink),
+                   detail::to_function_object(std::forward<Transform>(transform)));
+}
+
 template <typename InputContainer, typename Transform>
 auto transformed_to_same_container(InputContainer &&input, Transform &&transform)
 
@@ -128,6 +162,43 @@ auto transformed_with_new_return_type(InputContainer &&input, Transform &&transf
                                            std::forward<Transform>(transform));
 }
 
+// -------------------- transform_into --------------------
+// Transforms the items of input into output, which typically is a long lived buffer, whose
+// capacity is reused. output is cleared first, unless option is append_to_output.
+template <typename InputContainer, typename OutputContainer, typename Transform>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<OutputContainer>, Transform, ValueType<InputContainer>>
+#endif
+void transform_into(InputContainer &&input, OutputContainer &output, Transform &&transform,
+                    OutputOption option = overwrite_output)
+{
+    assert(!detail::is_same_object(input, output));
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        transform_into(detail::shared_input<InputContainer>(input), output,
+                       std::forward<Transform>(transform), option);
+        return;
+    }
+    detail::prepare_output(output, input.size(), option);
+    auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+    std::transform(range.begin(), range.end(), detail::insert_wrapper(output),
+                   detail::to_function_object(std::forward<Transform>(transform)));
+}
+
+// -------------------- transformed_reusing --------------------
+// transform_into, for buffers passed by value:
+//   buffer = transformed_reusing(input, transform, std::move(buffer));
+template <typename InputContainer, typename Transform, typename ResultContainer>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<ResultContainer>, Transform, ValueType<InputContainer>>
+#endif
+ResultContainer transformed_reusing(InputContainer &&input, Transform &&transform,
+                                    ResultContainer storage)
+{
+    kdalgorithms::transform_into(std::forward<InputContainer>(input), storage,
+                                 std::forward<Transform>(transform));
+    return storage;
+}
+
 // -------------------- transform --------------------
 template <typename Container, typename Transform>
 void transform(Container &input, Transform &&predicate)
@@ -148,6 +219,10 @@ namespace detail {
     ResultContainer filtered_transformed(InputContainer &&input, Transform &&transform,
                                          UnaryPredicate &&unaryPredicate, std::true_type)
     {
+        if (is_shared_rvalue<InputContainer>(input))
+            return filtered_transformed<ResultContainer>(
+                shared_input<InputContainer>(input),
+                std::forward<Transform>(transform), unaryPredicate, std::true_type());
         ResultContainer result;
         detail::reserve(result, input.size());
         auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
@@ -162,13 +237,17 @@ namespace detail {
     }
 
     // optimized version to use for r-values where container type is the same
-    // in-place editing is possible in that case.
+    // in-place editing is possible in that case, unless the container is shared (see is_shared).
     template <typename ResultContainer, typename InputContainer, typename Transform,
               typename UnaryPredicate>
     ResultContainer filtered_transformed(InputContainer &&input, Transform &&transform,
                                          UnaryPredicate &&unaryPredicate,
                                          std::false_type /* r-value and same containers */)
     {
+        if (is_shared(input))
+            return filtered_transformed<ResultContainer>(
+                shared_input<InputContainer>(input), std::forward<Transform>(transform),
+                unaryPredicate, std::true_type());
         auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
         auto writeIterator = std::begin(input);
         for (const auto &value : range) {
@@ -239,17 +318,276 @@ auto filtered_transformed(InputContainer &&input, Transform &&transform,
         detail::to_function_object(std::forward<UnaryPredicate>(unaryPredicate)));
 }
 
+// -------------------- filtered_transformed_into --------------------
+// Like filtered_transformed, but writes into output, like transform_into does.
+template <typename InputContainer, typename OutputContainer, typename Transform,
+          typename UnaryPredicate>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_r_v<ValueType<OutputContainer>, Transform, ValueType<InputContainer>>
+    && UnaryPredicateOnContainerValues<UnaryPredicate, InputContainer>
+#endif
+void filtered_transformed_into(InputContainer &&input, OutputContainer &output,
+                               Transform &&transform, UnaryPredicate &&unaryPredicate,
+                               OutputOption option = overwrite_output)
+{
+    assert(!detail::is_same_object(input, output));
+    if (detail::is_shared_rvalue<InputContainer>(input)) {
+        filtered_transformed_into(detail::shared_input<InputContainer>(input), output,
+                                  std::forward<Transform>(transform),
+                                  std::forward<UnaryPredicate>(unaryPredicate), option);
+        return;
+    }
+    detail::prepare_output(output, input.size(), option);
+    auto function = detail::to_function_object(std::forward<Transform>(transform));
+    auto predicate = detail::to_function_object(std::forward<UnaryPredicate>(unaryPredicate));
+    auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+    auto inserter = detail::insert_wrapper(output);
+    for (const auto &value : range) {
+        if (predicate(value)) {
+            *inserter = function(value);
+            ++inserter;
+        }
+    }
+}
+
+// -------------------- flat_transformed --------------------
+// How flat_transformed sizes its result: flatten_single_pass lets the result grow as the inner
+// containers are appended, while flatten_reserve_exact first collects all the inner containers,
+// and then reserves the exact size of the result.
+enum FlattenOption { flatten_single_pass, flatten_reserve_exact };
+
+namespace detail {
+    // Inner containers returned by value are moved from, while those returned by reference
+    // (like a member container) are copied.
+    template <typename ResultContainer, typename Inner>
+    void append_flattened(ResultContainer &result, Inner &&inner)
+    {
+        detail::copy_or_move(std::begin(inner), std::end(inner), detail::insert_wrapper(result),
+                             std::is_lvalue_reference<Inner>());
+    }
+
+    template <typename ResultContainer, typename InputContainer, typename Transform>
+    void flatten_into(ResultContainer &result, InputContainer &&input, Transform &transform)
+    {
+        auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+        for (auto &&item : range)
+            append_flattened(result, transform(std::forward<decltype(item)>(item)));
+    }
+
+    template <typename T>
+    T &unwrap_inner(std::reference_wrapper<T> inner)
+    {
+        return inner.get();
+    }
+
+    template <typename T>
+    T &&unwrap_inner(T &inner)
+    {
+        return std::move(inner);
+    }
+
+    template <typename ResultContainer, typename InputContainer, typename Transform>
+    ResultContainer flat_transformed(InputContainer &&input, Transform &transform,
+                                     FlattenOption option, std::true_type /*is FlattenOption*/)
+    {
+        ResultContainer result;
+        if (option == flatten_single_pass) {
+            flatten_into(result, std::forward<InputContainer>(input), transform);
+            return result;
+        }
+
+        // Keep the inner containers, or references to them, until the total size is known.
+        using Inner = detail::invoke_result_t<Transform, ValueType<InputContainer>>;
+        using Stored = std::conditional_t<std::is_lvalue_reference<Inner>::value,
+                                          std::reference_wrapper<std::remove_reference_t<Inner>>,
+                                          remove_cvref_t<Inner>>;
+        std::vector<Stored> inners;
+        inners.reserve(input.size());
+        std::size_t size = 0;
+        auto range = read_iterator_wrapper(std::forward<InputContainer>(input));
+        for (auto &&item : range) {
+            inners.push_back(transform(std::forward<decltype(item)>(item)));
+            size += unwrap_inner(inners.back()).size();
+        }
+
+        detail::reserve(result, size);
+        for (auto &inner : inners)
+            append_flattened(result, unwrap_inner(inner));
+        return result;
+    }
+
+    // sizeEstimator(item) estimates how many items the inner container for item will have.
+    template <typename ResultContainer, typename InputContainer, typename Transform,
+              typename SizeEstimator>
+    ResultContainer flat_transformed(InputContainer &&input, Transform &transform,
+                                     SizeEstimator &sizeEstimator,
+                                     std::false_type /*is FlattenOption*/)
+    {
+        std::size_t size = 0;
+        for (const auto &item : input)
+            size += static_cast<std::size_t>(detail::invoke(sizeEstimator, item));
+
+        ResultContainer result;
+        detail::reserve(result, size);
+        flatten_into(result, std::forward<InputContainer>(input), transform);
+        return result;
+    }
+
+    template <typename ResultContainer, typename InputContainer, typename Transform,
+              typename Sizing>
+    ResultContainer flat_transformed(InputContainer &&input, Transform &&transform,
+                                     Sizing &sizing)
+    {
+        if (is_shared_rvalue<InputContainer>(input))
+            return detail::flat_transformed<ResultContainer>(
+                shared_input<InputContainer>(input), std::forward<Transform>(transform), sizing);
+        auto function = detail::to_function_object(std::forward<Transform>(transform));
+        return flat_transformed<ResultContainer>(std::forward<InputContainer>(input), function,
+                                                 sizing, std::is_same<Sizing, FlattenOption>());
+    }
+
+    template <typename InputContainer, typename Transform>
+    using FlattenedItemType =
+        ValueType<remove_cvref_t<detail::invoke_result_t<Transform, ValueType<InputContainer>>>>;
+} // namespace detail
+
+// Calls transform on each item, which must return a container, and concatenates these
+// containers. The result has the type returned by transform, unless specified.
+template <typename InputContainer, typename Transform, typename Sizing = FlattenOption>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Transform, ValueType<InputContainer>>
+#endif
+auto flat_transformed(InputContainer &&input, Transform &&transform,
+                      Sizing sizing = flatten_single_pass)
+{
+    using ResultType =
+        remove_cvref_t<detail::invoke_result_t<Transform, ValueType<InputContainer>>>;
+    return detail::flat_transformed<ResultType>(std::forward<InputContainer>(input),
+                                                std::forward<Transform>(transform), sizing);
+}
+
+template <template <typename...> class ResultContainer, typename InputContainer, typename Transform,
+          typename Sizing = FlattenOption>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Transform, ValueType<InputContainer>>
+#endif
+auto flat_transformed(InputContainer &&input, Transform &&transform,
+                      Sizing sizing = flatten_single_pass)
+{
+    return detail::flat_transformed<
+        ResultContainer<detail::FlattenedItemType<InputContainer, Transform>>>(
+        std::forward<InputContainer>(input), std::forward<Transform>(transform), sizing);
+}
+
+template <typename ResultContainer, typename InputContainer, typename Transform,
+          typename Sizing = FlattenOption>
+#if __cplusplus >= 202002L
+    requires std::is_invocable_v<Transform, ValueType<InputContainer>>
+#endif
+auto flat_transformed(InputContainer &&input, Transform &&transform,
+                      Sizing sizing = flatten_single_pass)
+{
+    return detail::flat_transformed<ResultContainer>(std::forward<InputContainer>(input),
+                                                     std::forward<Transform>(transform), sizing);
+}
+
 namespace detail {
+    // Builds a new map, used for l-values, and r-values which can't be reused
     template <typename ResultMap, typename Map, typename Transform>
-    auto transformed_map_values(Map &&input, Transform &&transform)
+    ResultMap rebuild_map_values(Map &&input, Transform &&transform,
+                                 std::false_type /* r-value with extract */)
     {
         return transformed<ResultMap>(
             std::forward<Map>(input),
             [transform = std::forward<Transform>(transform)](auto &&pair) {
-                return std::make_pair(pair.first, transform(pair.second));
+                // The values of r-value maps are moved into the transform
+                return std::make_pair(pair.first,
+                                      transform(std::forward<decltype(pair)>(pair).second));
             });
     }
 
+    // Inserting a std::pair into a std map would copy the key, as it is const in value_type
+    template <typename Map, typename Key, typename Value>
+    void emplace_back(Map &map, Key &&key, Value &&value, std::false_type /*has_keyValueBegin*/)
+    {
+        map.emplace_hint(map.end(), std::forward<Key>(key), std::forward<Value>(value));
+    }
+
+    template <typename Map, typename Key, typename Value>
+    void emplace_back(Map &map, Key &&key, Value &&value, std::true_type /*has_keyValueBegin*/)
+    {
+        *detail::insert_wrapper(map) = std::make_pair(std::forward<Key>(key),
+                                                      std::forward<Value>(value));
+    }
+
+    // The nodes of r-value std maps are extracted one by one, so their keys can be moved into the
+    // result (C++17)
+    template <typename ResultMap, typename Map, typename Transform>
+    ResultMap rebuild_map_values(Map &&input, Transform &&transform,
+                                 std::true_type /* r-value with extract */)
+    {
+        ResultMap result;
+        detail::reserve(result, input.size());
+        while (!input.empty()) {
+            auto node = input.extract(input.begin());
+            emplace_back(result, std::move(node.key()), transform(std::move(node.mapped())),
+                         has_keyValueBegin<ResultMap>());
+        }
+        return result;
+    }
+
+    template <typename Map, typename Transform>
+    void transform_map_values_in_place(Map &map, Transform &transform,
+                                       std::false_type /*has_keyValueBegin*/)
+    {
+        for (auto &pair : map)
+            pair.second = transform(std::move(pair.second));
+    }
+
+    // QMap and QHash
+    template <typename Map, typename Transform>
+    void transform_map_values_in_place(Map &map, Transform &transform,
+                                       std::true_type /*has_keyValueBegin*/)
+    {
+        for (auto it = map.begin(); it != map.end(); ++it)
+            it.value() = transform(std::move(it.value()));
+    }
+
+    template <typename ResultMap, typename Map, typename Transform>
+    ResultMap transformed_map_values(Map &&input, Transform &&transform);
+
+    // R-values where the map type stays the same are reused, so neither keys nor nodes are
+    // copied, unless the map is shared (see is_shared).
+    template <typename ResultMap, typename Map, typename Transform>
+    ResultMap transformed_map_values(Map &&input, Transform &&transform,
+                                     std::true_type /* r-value and same maps */)
+    {
+        if (is_shared(input))
+            return transformed_map_values<ResultMap>(shared_input<Map>(input),
+                                                     std::forward<Transform>(transform));
+        transform_map_values_in_place(input, transform, has_keyValueBegin<Map>());
+        return std::move(input);
+    }
+
+    template <typename ResultMap, typename Map, typename Transform>
+    ResultMap transformed_map_values(Map &&input, Transform &&transform,
+                                     std::false_type /* r-value and same maps */)
+    {
+        return rebuild_map_values<ResultMap>(
+            std::forward<Map>(input), std::forward<Transform>(transform),
+            std::integral_constant<bool,
+                                   !std::is_lvalue_reference<Map>::value
+                                       && has_extract<remove_cvref_t<Map>>::value>());
+    }
+
+    template <typename ResultMap, typename Map, typename Transform>
+    ResultMap transformed_map_values(Map &&input, Transform &&transform)
+    {
+        return transformed_map_values<ResultMap>(
+            std::forward<Map>(input), std::forward<Transform>(transform),
+            std::integral_constant<bool, !decltype(need_new_container<Map, ResultMap>)::value>());
+    }
+
     template <typename NewValue, template <typename...> class Map, typename Key, typename OldValue>
     auto map_value(const Map<Key, OldValue> &) -> Map<remove_cvref_t<Key>, remove_cvref_t<NewValue>>
     {
@@ -0,0 +1,285 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+#pragma once
+
+#include "chunked.h"
+#include "insert_wrapper.h"
+#include "invoke.h"
+#include "read_iterator_wrapper.h"
+#include "reserve_helper.h"
+#include "shared.h"
+#include "tuple_utils.h"
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kdalgorithms {
+namespace detail {
+    // Members are moved out of the items of r-value containers. Other projections are called
+    // with an l-value, as the item is given to each of the projections in turn.
+    template <typename Projection, typename Item>
+    decltype(auto) unzip_project(Projection &projection, Item &item,
+                                 std::true_type /*move member*/)
+    {
+        return detail::invoke(projection, std::move(item));
+    }
+
+    template <typename Projection, typename Item>
+    decltype(auto) unzip_project(Projection &projection, Item &item,
+                                 std::false_type /*move member*/)
+    {
+        return detail::invoke(projection, item);
+    }
+
+    template <typename Columns, typename Container>
+    void reserve_columns(Columns &columns, const Container &container)
+    {
+        tuple_apply(columns, [&](auto &column) { detail::reserve(column, container.size()); });
+    }
+
+    template <template <typename...> class ResultContainer, typename Item,
+              std::size_t... Indices>
+    using unzipped_t =
+        std::tuple<ResultContainer<remove_cvref_t<std::tuple_element_t<Indices, Item>>>...>;
+
+    template <template <typename...> class ResultContainer, typename Item,
+              typename... Projections>
+    using unzipped_projected_t =
+        std::tuple<ResultContainer<remove_cvref_t<detail::invoke_result_t<Projections, Item>>>...>;
+
+    template <template <typename...> class ResultContainer, typename Container,
+              std::size_t... Indices>
+    unzipped_t<ResultContainer, ValueType<Container>, Indices...>
+    unzipped(Container &&container, std::index_sequence<Indices...> indices)
+    {
+        if (is_shared_rvalue<Container>(container))
+            return unzipped<ResultContainer>(shared_input<Container>(container), indices);
+        unzipped_t<ResultContainer, ValueType<Container>, Indices...> result;
+        reserve_columns(result, container);
+        auto inserters = std::make_tuple(detail::insert_wrapper(std::get<Indices>(result))...);
+
+        auto range = read_iterator_wrapper(std::forward<Container>(container));
+        for (auto &&item : range) {
+            // Each get moves a different element out of r-value items
+            int dummy[] = {(*std::get<Indices>(inserters) =
+                                std::get<Indices>(std::forward<decltype(item)>(item)),
+                            ++std::get<Indices>(inserters), 0)...};
+            (void)dummy;
+        }
+        return result;
+    }
+
+    template <template <typename...> class ResultContainer, typename Container,
+              std::size_t... Indices, typename... Projections>
+    unzipped_projected_t<ResultContainer, ValueType<Container>, Projections...>
+    unzipped_projected(Container &&container, std::index_sequence<Indices...> indices,
+                       Projections &...projections)
+    {
+        if (is_shared_rvalue<Container>(container))
+            return unzipped_projected<ResultContainer>(shared_input<Container>(container),
+                                                       indices, projections...);
+        unzipped_projected_t<ResultContainer, ValueType<Container>, Projections...> result;
+        reserve_columns(result, container);
+        auto inserters = std::make_tuple(detail::insert_wrapper(std::get<Indices>(result))...);
+
+        auto range = read_iterator_wrapper(std::forward<Container>(container));
+        for (auto &&item : range) {
+            int dummy[] = {
+                (*std::get<Indices>(inserters) = unzip_project(
+                     projections, item,
+                     std::integral_constant<bool,
+                                            !std::is_lvalue_reference<Container>::value
+                                                && std::is_member_object_pointer<
+                                                    Projections>::value>()),
+                 ++std::get<Indices>(inserters), 0)...};
+            (void)dummy;
+        }
+        return result;
+    }
+
+    // The reference type of soa_view: a tuple of references to the items of the columns at one
+    // index. Assigning to it assigns to the items, and swapping it swaps the items, so the
+    // standard algorithms can reorder the columns through it.
+    template <typename... Ts>
+    class soa_reference : public std::tuple<Ts &...>
+    {
+        using Base = std::tuple<Ts &...>;
+        using Indices = std::index_sequence_for<Ts...>;
+
+    public:
+        using Base::Base;
+        soa_reference(const soa_reference &) = default;
+
+        soa_reference &operator=(const soa_reference &other)
+        {
+            Base::operator=(static_cast<const Base &>(other));
+            return *this;
+        }
+
+        soa_reference &operator=(soa_reference &&other)
+        {
+            assign_moved(other, Indices());
+            return *this;
+        }
+
+        soa_reference &operator=(const std::tuple<Ts...> &values)
+        {
+            Base::operator=(values);
+            return *this;
+        }
+
+        soa_reference &operator=(std::tuple<Ts...> &&values)
+        {
+            Base::operator=(std::move(values));
+            return *this;
+        }
+
+        friend void swap(soa_reference x, soa_reference y) { x.swap_items(y, Indices()); }
+
+    private:
+        template <std::size_t... I>
+        void assign_moved(soa_reference &other, std::index_sequence<I...>)
+        {
+            int dummy[] = {(std::get<I>(*this) = std::move(std::get<I>(other)), 0)...};
+            (void)dummy;
+        }
+
+        template <std::size_t... I>
+        void swap_items(soa_reference &other, std::index_sequence<I...>)
+        {
+            using std::swap;
+            int dummy[] = {(swap(std::get<I>(*this), std::get<I>(other)), 0)...};
+            (void)dummy;
+        }
+    };
+
+    template <typename Column>
+    using ColumnItemType = std::remove_reference_t<decltype(*std::begin(std::declval<Column &>()))>;
+
+    template <typename... Columns>
+    class soa_columns_view
+    {
+    public:
+        using iterator = view_iterator<soa_columns_view>;
+        using const_iterator = iterator;
+        using value_type = std::tuple<std::remove_const_t<ColumnItemType<Columns>>...>;
+        using reference = soa_reference<ColumnItemType<Columns>...>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        explicit soa_columns_view(Columns &...columns)
+            : m_columns(columns...)
+        {
+            assert(all_of_size(size()));
+        }
+
+        iterator begin() const { return {this, 0}; }
+        iterator end() const { return {this, static_cast<difference_type>(size())}; }
+        size_type size() const { return static_cast<size_type>(std::get<0>(m_columns).size()); }
+        bool empty() const { return size() == 0; }
+
+        reference at(difference_type index) const
+        {
+            return at(index, std::index_sequence_for<Columns...>());
+        }
+        reference operator[](difference_type index) const { return at(index); }
+
+        // Erases the rows [first, last) from all the columns, which makes kdalgorithms::filter and
+        // kdalgorithms::erase_if work on the view.
+        void erase(iterator first, iterator last)
+        {
+            const auto from = first - begin();
+            const auto to = last - begin();
+            tuple_apply(m_columns, [&](auto &column) {
+                column.erase(std::next(std::begin(column), from),
+                             std::next(std::begin(column), to));
+            });
+        }
+
+    private:
+        template <std::size_t... Indices>
+        reference at(difference_type index, std::index_sequence<Indices...>) const
+        {
+            return reference(std::begin(std::get<Indices>(m_columns))[index]...);
+        }
+
+        bool all_of_size(size_type size)
+        {
+            bool result = true;
+            tuple_apply(m_columns, [&](auto &column) {
+                result = result && static_cast<size_type>(column.size()) == size;
+            });
+            return result;
+        }
+
+        std::tuple<Columns &...> m_columns;
+    };
+
+    template <typename... Columns>
+    struct is_view<soa_columns_view<Columns...>> : std::true_type
+    {
+    };
+} // namespace detail
+
+// -------------------- unzipped --------------------
+// The opposite of zip: splits a container of tuples (or pairs) into a tuple of containers, one
+// per element of the tuples.
+template <template <typename...> class ResultContainer = std::vector, typename Container>
+auto unzipped(Container &&container)
+{
+    using Item = ValueType<Container>;
+    return detail::unzipped<ResultContainer>(
+        std::forward<Container>(container),
+        std::make_index_sequence<std::tuple_size<Item>::value>());
+}
+
+// Splits a container of structs into a tuple of containers, one per projection, like
+// unzipped(people, &Person::name, &Person::age).
+template <template <typename...> class ResultContainer = std::vector, typename Container,
+          typename Projection, typename... Projections>
+auto unzipped(Container &&container, Projection projection, Projections... projections)
+{
+    return detail::unzipped_projected<ResultContainer>(
+        std::forward<Container>(container),
+        std::make_index_sequence<sizeof...(Projections) + 1>(), projection, projections...);
+}
+
+// -------------------- soa_view --------------------
+// Presents a number of columns (containers with random access iterators and the same size)
+// as one container, whose items are tuples of the items in the columns at the same index.
+// Reordering the view, e.g. with sort_by, reorders all the columns, and filter and erase_if
+// erase from all the columns.
+template <typename... Columns>
+auto soa_view(Columns &...columns)
+{
+    static_assert(sizeof...(Columns) > 0, "soa_view requires at least one column");
+    return detail::soa_columns_view<Columns...>(columns...);
+}
+
+} // namespace kdalgorithms
+
+namespace std {
+template <typename... Ts>
+struct tuple_size<kdalgorithms::detail::soa_reference<Ts...>>
+    : std::integral_constant<std::size_t, sizeof...(Ts)>
+{
+};
+
+template <std::size_t I, typename... Ts>
+struct tuple_element<I, kdalgorithms::detail::soa_reference<Ts...>>
+{
+    using type = std::tuple_element_t<I, std::tuple<Ts &...>>;
+};
+} // namespace std
@@ -9,7 +9,9 @@
 ****************************************************************************/
 #pragma once
 
+#include "read_iterator_wrapper.h"
 #include "shared.h"
+#include "sink.h"
 #include "tuple_utils.h"
 #include <iterator>
 #include <tuple>
@@ -35,22 +37,51 @@ namespace detail {
     {
         return at_end_helper(iterators, std::index_sequence_for<Iterators...>{});
     }
+
+    template <typename OutputIterator, typename... Containers>
+    void zip_containers(OutputIterator out, Containers &&...containers)
+    {
+        auto iterators =
+            std::make_tuple(read_iterator_wrapper(std::forward<Containers>(containers))...);
+
+        while (!detail::at_end(iterators)) {
+            auto oneZip =
+                detail::tuple_apply_with_result(iterators, [](auto it) { return *(it.begin()); });
+            *out = std::move(oneZip);
+            ++out;
+            detail::tuple_apply(iterators, [](auto &it) { ++it; });
+        }
+    }
+
+    // If any of the containers is a shared r-value, all of them are read through shared_input,
+    // so unshared Qt containers given as r-values are then copied from rather than moved from.
+    template <typename OutputIterator, typename... Containers>
+    void zip(OutputIterator out, Containers &&...containers)
+    {
+        bool anyShared = false;
+        int dummy[] = {
+            (anyShared = anyShared || is_shared_rvalue<Containers>(containers), 0)...};
+        (void)dummy;
+        if (anyShared)
+            zip_containers(std::move(out), shared_input<Containers>(containers)...);
+        else
+            zip_containers(std::move(out), std::forward<Containers>(containers)...);
+    }
 } // namespace detail
 
 template <template <typename...> class ResultContainer = std::vector, typename... Containers>
 auto zip(Containers &&...containers)
 {
-    auto iterators =
-        std::make_tuple(read_iterator_wrapper(std::forward<Containers>(containers))...);
-
     using TupleValueType = std::tuple<ValueType<Containers>...>;
     ResultContainer<TupleValueType> result;
-    while (!detail::at_end(iterators)) {
-        auto oneZip =
-            detail::tuple_apply_with_result(iterators, [](auto it) { return *(it.begin()); });
-        result.push_back(std::move(oneZip));
-        detail::tuple_apply(iterators, [](auto &it) { ++it; });
-    }
+    detail::zip(std::back_inserter(result), std::forward<Containers>(containers)...);
     return result;
 }
+
+// Hands the tuples to sink (see to_sink) one by one, rather than returning them in a container.
+template <typename Sink, typename... Containers>
+void zip(detail::sink_iterator<Sink> sink, Containers &&...containers)
+{
+    detail::zip(std::move(sink), std::forward<Containers>(containers)...);
+}
 }
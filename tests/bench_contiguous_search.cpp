@@ -0,0 +1,97 @@
+/****************************************************************************
+**
+** This file is part of KDAlgorithms
+**
+** SPDX-FileCopyrightText: 2022 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+**
+** SPDX-License-Identifier: MIT
+**
+****************************************************************************/
+
+// Compares contains and count, which use the kernels from contiguous_search.h for contiguous
+// containers of integers, with std::find and std::count. The needle is the last item, so the
+// whole container is searched. Build in release mode to get meaningful numbers.
+
+#include "../src/kdalgorithms.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+// Keeps the compiler from optimizing the measured code away
+template <typename T>
+void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile T sink;
+    sink = value;
+#endif
+}
+
+template <typename Function>
+double microSecondsPerRun(Function &&function)
+{
+    // The best of several rounds, to reduce the noise from other processes
+    constexpr int rounds = 5;
+    constexpr int runs = 500;
+    double best = std::numeric_limits<double>::max();
+    for (int round = 0; round < rounds; ++round) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < runs; ++i)
+            doNotOptimize(function());
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, std::chrono::duration<double, std::micro>(elapsed).count() / runs);
+    }
+    return best;
+}
+
+template <typename T>
+void benchmark(const std::string &name)
+{
+    std::vector<T> items(1 << 16, T(1));
+    items.back() = T(2);
+    const T needle = T(2);
+
+    const auto find = microSecondsPerRun([&] {
+        doNotOptimize(items.data());
+        return std::find(items.cbegin(), items.cend(), needle) != items.cend();
+    });
+    const auto contains = microSecondsPerRun([&] {
+        doNotOptimize(items.data());
+        return kdalgorithms::contains(items, needle);
+    });
+    const auto count = microSecondsPerRun([&] {
+        doNotOptimize(items.data());
+        return std::count(items.cbegin(), items.cend(), needle);
+    });
+    const auto kdCount = microSecondsPerRun([&] {
+        doNotOptimize(items.data());
+        return kdalgorithms::count(items, needle);
+    });
+
+    std::cout << std::setw(10) << name << std::fixed << std::setprecision(2) << std::setw(12)
+              << find << std::setw(12) << contains << std::setw(12) << count << std::setw(12)
+              << kdCount << '\n';
+}
+} // namespace
+
+int main()
+{
+    std::cout << "Microseconds per search of " << (1 << 16) << " items\n"
+              << std::setw(10) << "item" << std::setw(12) << "std::find" << std::setw(12)
+              << "contains" << std::setw(12) << "std::count" << std::setw(12) << "count"
+              << '\n';
+    benchmark<char>("char");
+    benchmark<char16_t>("char16_t");
+    benchmark<wchar_t>("wchar_t");
+    benchmark<std::int32_t>("int32_t");
+    benchmark<std::int64_t>("int64_t");
+}
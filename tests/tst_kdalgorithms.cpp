@@ -12,14 +12,19 @@
 #include "ContainerObserver.h"
 #include "copy_observer.h"
 #include <QList>
+#include <QSet>
 #include <QTest>
 #include <QVector>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <deque>
 #include <forward_list>
 #include <iostream>
+#include <memory>
 #include <set>
+#include <stdexcept>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -41,6 +46,12 @@ QString toString(int x)
     return QString::number(x);
 }
 
+int sunkTotal = 0;
+void addToSunkTotal(int x)
+{
+    sunkTotal += x;
+}
+
 std::function<bool(int)> greaterThan(int testValue)
 {
     return [testValue](int value) { return value > testValue; };
@@ -91,6 +102,28 @@ struct Person
     bool operator==(const Person &other) const { return name == other.name && age == other.age; }
 };
 
+// Mimics an implicitly shared Qt container, which is detached by calling non-const begin()
+template <typename T>
+class SharedVector : public std::vector<T>
+{
+public:
+    using std::vector<T>::vector;
+
+    bool isDetached() const { return !shared; }
+    typename std::vector<T>::iterator begin()
+    {
+        if (shared) {
+            ++detachCount;
+            shared = false;
+        }
+        return std::vector<T>::begin();
+    }
+    typename std::vector<T>::const_iterator begin() const { return std::vector<T>::begin(); }
+
+    bool shared = false;
+    int detachCount = 0;
+};
+
 } // namespace
 class TestAlgorithms : public QObject
 {
@@ -113,17 +146,26 @@ private Q_SLOTS:
     void transformedChangeContainerAndDataType2();
     void transformedChangeDataType();
     void transformedWithRValue();
+    void transformedReusing();
+    void transformInto();
+    void filterInto();
+    void filteredTransformedInto();
+    void toSink();
     void transformMemberFunction();
     void transformOtherContainers();
     void transformedMemberVariable();
     void transformedStaticFunctions();
     void transform();
     void filtered_transformed();
+    void flat_transformed();
+    void flat_transformedSizing();
     void transformed_map_values();
     void anyOf();
     void allOf();
     void noneOf();
     void anyAllNoneOtherContainers();
+    void parallelAnyAllNone();
+    void parallelFindIf();
     void reverse();
     void reversed();
     void reversedEnsureMoveOnly();
@@ -133,14 +175,26 @@ private Q_SLOTS:
     void sortedWithCompare();
     void sortedEnsureMoveOnly();
     void sortBy();
+    void merged();
+    void mergedBy();
     void is_sorted();
     void lvalue();
     void contains();
     void value_in();
+    void static_set();
     void count();
+    void associativeLookup();
+    void contiguousSearch();
     void count_if();
+    void sorted_lookup();
+    void eytzinger_index();
     void max_value();
     void min_value();
+    void minmax_value();
+    void minmax_by();
+    void min_max_index();
+    void min_max_ref();
+    void min_max_by();
     void maxValueLessThan();
     void maxValueLessThanCustomComparisor();
     void maxValueLessThanUnordered();
@@ -150,6 +204,7 @@ private Q_SLOTS:
     void minValueGreaterThanUnorderedCustomComparisor();
     void minValueGreaterThanCustomComparisor();
     void isPermutation();
+    void isPermutationLarge();
     void accumulate();
     void accumulateAndMemberFunctions();
     void accumulate_if();
@@ -159,6 +214,9 @@ private Q_SLOTS:
     void accumulateWithMap();
     void sum();
     void sum_if();
+    void scans();
+    void scansWithProjection();
+    void parallelScans();
     void get_match();
     void get_match_or_default();
     void remove_duplicates();
@@ -166,6 +224,8 @@ private Q_SLOTS:
     void has_duplicates_data();
     void erase();
     void erase_if();
+    void branchlessCompaction();
+    void selectIndicesAndMasks();
     void combiningTests();
     void index_of_match();
     void find_if();
@@ -179,12 +239,27 @@ private Q_SLOTS:
     void generate_until();
     void isSame();
     void zip();
+    void unzipped();
+    void unzippedWithProjections();
+    void soaView();
+    void enumerate();
+    void detachAwareRValues();
     void for_each();
     void invoke();
     void multi_partitioned();
     void multi_partitioned_with_function_taking_a_value();
+    void groupAdjacent();
+    void chunkBy();
+    void chunked();
+    void windowed();
+    void strided();
     void sub_range();
     void product();
+    void joined();
+    void left_joined();
+    void semi_anti_joined();
+    void set_algebra();
+    void set_algebra_unordered();
 };
 
 void TestAlgorithms::copy()
@@ -666,6 +741,181 @@ void TestAlgorithms::transformedWithRValue()
     }
 }
 
+void TestAlgorithms::transformedReusing()
+{
+    auto toDouble = [](int i) { return i * 1.5; };
+    std::vector<double> buffer;
+    buffer.reserve(10);
+    buffer.push_back(42);
+    const double *data = buffer.data();
+
+    buffer = kdalgorithms::transformed_reusing(intVector, toDouble, std::move(buffer));
+    QCOMPARE(buffer, (std::vector<double>{1.5, 3, 4.5, 6}));
+    QCOMPARE(buffer.data(), data);
+
+    buffer = kdalgorithms::transformed_reusing(getIntVector(), squareItem, std::move(buffer));
+    QCOMPARE(buffer, (std::vector<double>{1, 4, 9, 16}));
+    QCOMPARE(buffer.data(), data);
+
+    { // Other containers
+        auto result =
+            kdalgorithms::transformed_reusing(intVector, &toString, QStringList{"old", "items"});
+        QStringList expected{"1", "2", "3", "4"};
+        QCOMPARE(result, expected);
+    }
+
+    { // Items are moved out of r-values
+        std::vector<std::unique_ptr<int>> pointers;
+        pointers.push_back(std::make_unique<int>(1));
+        pointers.push_back(std::make_unique<int>(2));
+        auto result = kdalgorithms::transformed_reusing(
+            std::move(pointers),
+            [](std::unique_ptr<int> p) {
+                *p += 10;
+                return p;
+            },
+            std::vector<std::unique_ptr<int>>());
+        QCOMPARE(*result[1], 12);
+    }
+}
+
+void TestAlgorithms::transformInto()
+{
+    std::vector<int> buffer;
+    kdalgorithms::transform_into(intVector, buffer, squareItem);
+    QCOMPARE(buffer, (std::vector<int>{1, 4, 9, 16}));
+    const int *data = buffer.data();
+
+    // Overwriting keeps the capacity
+    kdalgorithms::transform_into(std::vector<int>{5, 6}, buffer, squareItem);
+    QCOMPARE(buffer, (std::vector<int>{25, 36}));
+    QCOMPARE(buffer.data(), data);
+
+    kdalgorithms::transform_into(std::vector<int>{7}, buffer, squareItem,
+                                 kdalgorithms::append_to_output);
+    QCOMPARE(buffer, (std::vector<int>{25, 36, 49}));
+    QCOMPARE(buffer.data(), data);
+
+    { // Other containers
+        QStringList strings{"old"};
+        kdalgorithms::transform_into(intVector, strings, &toString);
+        QStringList expected{"1", "2", "3", "4"};
+        QCOMPARE(strings, expected);
+
+        std::set<int> set{100};
+        kdalgorithms::transform_into(intVector, set, squareItem, kdalgorithms::append_to_output);
+        QCOMPARE(set, (std::set<int>{1, 4, 9, 16, 100}));
+    }
+}
+
+void TestAlgorithms::filterInto()
+{
+    std::vector<int> buffer{10, 20, 30, 40, 50};
+    const int *data = buffer.data();
+    kdalgorithms::filter_into(intVector, buffer, isOdd);
+    QCOMPARE(buffer, (std::vector<int>{1, 3}));
+    QCOMPARE(buffer.data(), data);
+
+    kdalgorithms::filter_into(std::vector<int>{5, 6, 7}, buffer, isOdd,
+                              kdalgorithms::append_to_output);
+    QCOMPARE(buffer, (std::vector<int>{1, 3, 5, 7}));
+
+    { // Items are moved out of r-values
+        std::vector<std::unique_ptr<int>> pointers;
+        pointers.push_back(std::make_unique<int>(1));
+        pointers.push_back(std::make_unique<int>(2));
+        std::vector<std::unique_ptr<int>> result;
+        kdalgorithms::filter_into(std::move(pointers), result,
+                                  [](const std::unique_ptr<int> &p) { return *p == 2; });
+        QCOMPARE(result.size(), 1u);
+        QCOMPARE(*result[0], 2);
+    }
+}
+
+void TestAlgorithms::filteredTransformedInto()
+{
+    std::vector<int> buffer{42};
+    kdalgorithms::filtered_transformed_into(intVector, buffer, squareItem, isOdd);
+    QCOMPARE(buffer, (std::vector<int>{1, 9}));
+
+    kdalgorithms::filtered_transformed_into(intVector, buffer, squareItem, greaterThan(2),
+                                            kdalgorithms::append_to_output);
+    QCOMPARE(buffer, (std::vector<int>{1, 9, 9, 16}));
+
+    std::deque<QString> strings;
+    kdalgorithms::filtered_transformed_into(intVector, strings, &toString, isOdd);
+    QCOMPARE(strings, (std::deque<QString>{"1", "3"}));
+}
+
+void TestAlgorithms::toSink()
+{
+    // Callable sink
+    {
+        int sum = 0;
+        kdalgorithms::transformed(intVector, squareItem,
+                                  kdalgorithms::to_sink([&sum](int i) { sum += i; }));
+        QCOMPARE(sum, 30);
+    }
+
+    // Free function, and pointer to it, as sink
+    {
+        sunkTotal = 0;
+        kdalgorithms::transformed(intVector, squareItem, kdalgorithms::to_sink(addToSunkTotal));
+        QCOMPARE(sunkTotal, 30);
+        kdalgorithms::filtered(intVector, isOdd, kdalgorithms::to_sink(&addToSunkTotal));
+        QCOMPARE(sunkTotal, 34);
+    }
+
+    // Output iterator sink
+    {
+        std::vector<int> result;
+        kdalgorithms::filtered(intVector, isOdd, kdalgorithms::to_sink(std::back_inserter(result)));
+        QCOMPARE(result, (std::vector<int>{1, 3}));
+    }
+
+    // r-values with move only items
+    {
+        std::vector<std::unique_ptr<int>> input;
+        for (int i = 0; i < 3; ++i)
+            input.push_back(std::make_unique<int>(i));
+        std::vector<std::unique_ptr<int>> result;
+        kdalgorithms::filtered(
+            std::move(input), [](const std::unique_ptr<int> &ptr) { return *ptr != 1; },
+            kdalgorithms::to_sink(std::back_inserter(result)));
+        QCOMPARE(result.size(), 2);
+        QCOMPARE(*result[1], 2);
+    }
+
+    {
+        std::vector<std::tuple<int, QString>> result;
+        std::vector<QString> strings{"a", "b", "c"};
+        kdalgorithms::zip(kdalgorithms::to_sink(std::back_inserter(result)), intVector, strings);
+        QCOMPARE(result,
+                 (std::vector<std::tuple<int, QString>>{{1, "a"}, {2, "b"}, {3, "c"}}));
+    }
+
+    {
+        int count = 0;
+        int sum = 0;
+        kdalgorithms::cartesian_product(kdalgorithms::to_sink([&](std::tuple<int, int, int> t) {
+                                            ++count;
+                                            sum += std::get<0>(t) * std::get<1>(t)
+                                                * std::get<2>(t);
+                                        }),
+                                        intVector, intVector, std::vector<int>{1, 2});
+        QCOMPARE(count, 32);
+        QCOMPARE(sum, 300);
+    }
+
+    {
+        std::vector<std::pair<bool, int>> result;
+        kdalgorithms::multi_partitioned(intVector, isOdd,
+                                        kdalgorithms::to_sink(std::back_inserter(result)));
+        QCOMPARE(result,
+                 (std::vector<std::pair<bool, int>>{{true, 1}, {false, 2}, {true, 3}, {false, 4}}));
+    }
+}
+
 void TestAlgorithms::transformMemberFunction()
 {
     {
@@ -872,6 +1122,95 @@ void TestAlgorithms::filtered_transformed()
     }
 }
 
+void TestAlgorithms::flat_transformed()
+{
+    std::vector<int> vec{1, 2, 3};
+    auto repeat = [](int i) { return std::vector<int>(i, i); };
+
+    {
+        auto result = kdalgorithms::flat_transformed(vec, repeat);
+        QCOMPARE(result, std::vector<int>({1, 2, 2, 3, 3, 3}));
+    }
+
+    { // Change the result container
+        auto result = kdalgorithms::flat_transformed<std::list>(vec, repeat);
+        QCOMPARE(result, std::list<int>({1, 2, 2, 3, 3, 3}));
+        auto result2 = kdalgorithms::flat_transformed<std::deque<int>>(vec, repeat);
+        QCOMPARE(result2, std::deque<int>({1, 2, 2, 3, 3, 3}));
+    }
+
+    { // Member variables are copied from, as the input is an l-value
+        struct Team
+        {
+            std::vector<QString> members;
+        };
+        std::vector<Team> teams{{{"Jesper", "Kalle"}}, {{}}, {{"Ivan"}}};
+        auto result = kdalgorithms::flat_transformed(teams, &Team::members);
+        QCOMPARE(result, std::vector<QString>({"Jesper", "Kalle", "Ivan"}));
+        QCOMPARE(teams[0].members.size(), 2u);
+    }
+
+    { // Inner containers returned by value are moved from
+        auto pointers = [](int i) {
+            std::vector<std::unique_ptr<int>> result;
+            result.push_back(std::make_unique<int>(i));
+            return result;
+        };
+        auto result = kdalgorithms::flat_transformed(vec, pointers);
+        QCOMPARE(result.size(), 3u);
+        QCOMPARE(*result[2], 3);
+    }
+
+    { // empty
+        std::vector<int> empty;
+        QVERIFY(kdalgorithms::flat_transformed(empty, repeat).empty());
+    }
+}
+
+void TestAlgorithms::flat_transformedSizing()
+{
+    std::vector<int> vec{1, 2, 3, 4};
+    auto repeat = [](int i) { return std::vector<int>(i, i); };
+    const std::vector<int> expected{1, 2, 2, 3, 3, 3, 4, 4, 4, 4};
+
+    {
+        auto result =
+            kdalgorithms::flat_transformed(vec, repeat, kdalgorithms::flatten_reserve_exact);
+        QCOMPARE(result, expected);
+        QCOMPARE(result.capacity(), expected.size());
+    }
+
+    { // size estimator
+        auto result = kdalgorithms::flat_transformed(vec, repeat, [](int i) { return i; });
+        QCOMPARE(result, expected);
+        QCOMPARE(result.capacity(), expected.size());
+    }
+
+    { // references to member containers
+        struct Team
+        {
+            std::vector<QString> members;
+        };
+        const std::vector<Team> teams{{{"Jesper", "Kalle"}}, {{"Ivan"}}};
+        auto result = kdalgorithms::flat_transformed(teams, &Team::members,
+                                                     kdalgorithms::flatten_reserve_exact);
+        QCOMPARE(result, std::vector<QString>({"Jesper", "Kalle", "Ivan"}));
+        QCOMPARE(result.capacity(), 3u);
+    }
+
+    { // r-value input with a move only inner type
+        std::vector<std::vector<std::unique_ptr<int>>> nested(3);
+        nested[0].push_back(std::make_unique<int>(1));
+        nested[2].push_back(std::make_unique<int>(2));
+        nested[2].push_back(std::make_unique<int>(3));
+        auto identity = [](std::vector<std::unique_ptr<int>> &&inner) { return std::move(inner); };
+        auto result = kdalgorithms::flat_transformed(std::move(nested), identity,
+                                                     kdalgorithms::flatten_reserve_exact);
+        QCOMPARE(result.size(), 3u);
+        QCOMPARE(*result[1], 2);
+    }
+}
+
 void TestAlgorithms::transformed_map_values()
 {
     std::map<int, int> map{{1, 2}, {2, 3}, {3, 4}};
@@ -925,6 +1264,61 @@ void TestAlgorithms::transformed_map_values()
         QCOMPARE(result, expected);
     }
 
+    { // The values of r-value maps are moved into the transform
+        std::map<int, CopyObserver> map;
+        map.emplace(1, 10);
+        map.emplace(2, 20);
+        CopyObserver::reset();
+        auto result = kdalgorithms::transformed_map_values(
+            std::move(map), [](CopyObserver observer) { return observer.value; });
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result, (std::map<int, int>{{1, 10}, {2, 20}}));
+    }
+
+    { // R-values of the same map type are transformed in place
+        std::map<int, std::string> map{{1, "a"}, {2, "b"}};
+        const std::string *address = &map.at(1);
+        auto result = kdalgorithms::transformed_map_values(std::move(map),
+                                                           [](std::string s) { return s + s; });
+        QCOMPARE(result, (std::map<int, std::string>{{1, "aa"}, {2, "bb"}}));
+        QCOMPARE(&result.at(1), address);
+    }
+
+    { // Same for QMap, unless it is shared
+        auto twice = [](const QString &s) { return s + s; };
+        QMap<int, QString> map{{1, "a"}, {2, "b"}};
+        auto result = kdalgorithms::transformed_map_values(std::move(map), twice);
+        QMap<int, QString> expected{{1, "aa"}, {2, "bb"}};
+        QCOMPARE(result, expected);
+
+        QMap<int, QString> shared{{1, "a"}, {2, "b"}};
+        const QMap<int, QString> copy = shared;
+        result = kdalgorithms::transformed_map_values(std::move(shared), twice);
+        QCOMPARE(result, expected);
+        QCOMPARE(copy.value(1), QString("a"));
+    }
+
+#if __cplusplus >= 201703L
+    { // The keys of r-value maps are moved into the new map
+        std::map<CopyObserver, int> map;
+        map.emplace(1, 10);
+        map.emplace(2, 20);
+        CopyObserver::reset();
+        auto result = kdalgorithms::transformed_map_values(
+            std::move(map), [](int i) { return std::to_string(i); });
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result.size(), 2u);
+        QCOMPARE(result.begin()->second, std::string("10"));
+    }
+#endif
+
+    { // Into a QMap, whose items are inserted at the end, as they are already sorted
+        std::map<int, int> map{{1, 2}, {2, 3}, {3, 4}, {4, 5}};
+        QMap<int, int> expected{{1, 4}, {2, 9}, {3, 16}, {4, 25}};
+        auto result = kdalgorithms::transformed_map_values<QMap>(map, squareItem);
+        QCOMPARE(result, expected);
+    }
+
     { // Complex example
         struct TimeOnProjects
         {
@@ -1026,6 +1420,106 @@ void TestAlgorithms::anyAllNoneOtherContainers()
     }
 }
 
+void TestAlgorithms::parallelAnyAllNone()
+{
+    QVERIFY(!kdalgorithms::parallel_any_of(intVector, greaterThan(10)));
+    QVERIFY(kdalgorithms::parallel_any_of(intVector, greaterThan(3)));
+    QVERIFY(!kdalgorithms::parallel_any_of(emptyIntVector, greaterThan(3)));
+    QVERIFY(kdalgorithms::parallel_any_of(structVec, &Struct::isKeyGreaterThanValue));
+
+    QVERIFY(kdalgorithms::parallel_all_of(intVector, greaterThan(0)));
+    QVERIFY(!kdalgorithms::parallel_all_of(intVector, greaterThan(1)));
+    QVERIFY(kdalgorithms::parallel_all_of(emptyIntVector, greaterThan(3)));
+
+    QVERIFY(kdalgorithms::parallel_none_of(intVector, greaterThan(10)));
+    QVERIFY(!kdalgorithms::parallel_none_of(intVector, greaterThan(3)));
+
+    std::vector<int> big(10000);
+    std::iota(big.begin(), big.end(), 0);
+    QVERIFY(kdalgorithms::parallel_any_of(big, [](int i) { return i == 9999; }));
+    QVERIFY(kdalgorithms::parallel_all_of(big, [](int i) { return i < 10000; }));
+    QVERIFY(!kdalgorithms::parallel_all_of(big, [](int i) { return i != 5000; }));
+    QVERIFY(kdalgorithms::parallel_none_of(big, [](int i) { return i < 0; }));
+
+    { // Containers without random access iterators are searched sequentially
+        std::map<int, std::string> map{{1, "abc"}, {2, "def"}, {3, "hij"}, {4, "klm"}};
+        auto has_key = [](int value) { return [value](auto item) { return item.first == value; }; };
+        QVERIFY(kdalgorithms::parallel_any_of(map, has_key(2)));
+        QVERIFY(!kdalgorithms::parallel_all_of(map, has_key(2)));
+        QVERIFY(kdalgorithms::parallel_none_of(map, has_key(42)));
+    }
+
+    { // Small containers are searched by the calling thread
+        const auto caller = std::this_thread::get_id();
+        std::atomic<bool> otherThread(false);
+        QVERIFY(!kdalgorithms::parallel_any_of(intVector, [&](int) {
+            if (std::this_thread::get_id() != caller)
+                otherThread = true;
+            return false;
+        }));
+        QVERIFY(!otherThread);
+    }
+
+    { // Exceptions are propagated to the caller
+        bool caught = false;
+        try {
+            kdalgorithms::parallel_any_of(big, [](int i) -> bool {
+                if (i == 1234)
+                    throw std::runtime_error("1234");
+                return false;
+            });
+        } catch (const std::runtime_error &) {
+            caught = true;
+        }
+        QVERIFY(caught);
+    }
+}
+
+void TestAlgorithms::parallelFindIf()
+{
+    {
+        auto result = kdalgorithms::parallel_find_if(intVector, [](int i) { return i > 2; });
+        QVERIFY(result.has_result());
+        QCOMPARE(*result, 3);
+        QCOMPARE(std::distance(result.begin, result.iterator), 2);
+
+        result = kdalgorithms::parallel_find_if(intVector, [](int i) { return i == 43; });
+        QVERIFY(!result);
+    }
+
+    { // The first match is found, no matter which thread finds a match first
+        std::vector<int> vec(10000);
+        std::iota(vec.begin(), vec.end(), 0);
+        for (int i = 0; i < 20; ++i) {
+            auto result =
+                kdalgorithms::parallel_find_if(vec, [](int x) { return x % 1000 == 999; });
+            QVERIFY(result.has_result());
+            QCOMPARE(*result, 999);
+        }
+    }
+
+    { // mutable results
+        std::vector<int> vec{1, 2, 3, 4};
+        auto result = kdalgorithms::parallel_find_if(vec, [](int i) { return i > 2; });
+        *result.iterator = 42;
+        std::vector<int> expected{1, 2, 42, 4};
+        QCOMPARE(vec, expected);
+    }
+
+    { // r-value
+        auto result = kdalgorithms::parallel_find_if(getStruct(), &Struct::hasEqualKeyValuePair);
+        QVERIFY(result.has_result());
+        QCOMPARE(result->key, 3);
+    }
+
+    { // Containers without random access iterators
+        std::list<int> list{1, 2, 3, 4};
+        auto result = kdalgorithms::parallel_find_if(list, [](int i) { return i > 2; });
+        QVERIFY(result.has_result());
+        QCOMPARE(*result, 3);
+    }
+}
+
 void TestAlgorithms::reverse()
 {
     std::vector<int> vec{1, 2, 3, 4};
@@ -1188,6 +1682,87 @@ void TestAlgorithms::sortBy()
     }
 }
 
+void TestAlgorithms::merged()
+{
+    {
+        std::vector<int> x{1, 4, 7};
+        std::vector<int> y{2, 5, 8, 9};
+        std::vector<int> z{3, 6};
+        std::vector<int> expected{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        QCOMPARE(kdalgorithms::merged(x, y, z), expected);
+        QCOMPARE(kdalgorithms::merged(x, emptyIntVector), x);
+    }
+
+    { // A range of containers, compared to sorting everything
+        std::vector<std::vector<int>> shards(37);
+        std::vector<int> all;
+        for (int i = 0; i < 1000; ++i) {
+            const int value = (i * 7919) % 503;
+            shards[static_cast<std::size_t>(i % 37 * (i % 3) % 37)].push_back(value);
+            all.push_back(value);
+        }
+        for (auto &shard : shards)
+            kdalgorithms::sort(shard);
+        QCOMPARE(kdalgorithms::merged(shards), kdalgorithms::sorted(all));
+
+        auto descending = kdalgorithms::transformed(shards, [](std::vector<int> shard) {
+            return kdalgorithms::sorted(shard, std::greater<int>());
+        });
+        QCOMPARE(kdalgorithms::merged(descending, std::greater<int>()),
+                 kdalgorithms::sorted(all, std::greater<int>()));
+
+        QCOMPARE(kdalgorithms::merged(std::vector<std::vector<int>>{}), emptyIntVector);
+    }
+
+    { // Stable, equal items are taken from the containers in the order the containers are given
+        using Pair = std::pair<int, char>;
+        std::vector<Pair> x{{1, 'x'}, {2, 'x'}};
+        std::vector<Pair> y{{1, 'y'}, {2, 'y'}, {3, 'y'}};
+        std::vector<Pair> z{{2, 'z'}};
+        auto byFirst = [](const Pair &p, const Pair &q) { return p.first < q.first; };
+        std::vector<std::vector<Pair>> containers{x, y, z};
+        std::vector<Pair> expected{{1, 'x'}, {1, 'y'}, {2, 'x'}, {2, 'y'}, {2, 'z'}, {3, 'y'}};
+        QCOMPARE(kdalgorithms::merged(containers, byFirst), expected);
+    }
+
+    { // Other containers
+        std::list<int> x{1, 3};
+        std::list<int> y{2};
+        std::list<int> expected{1, 2, 3};
+        QCOMPARE(kdalgorithms::merged(x, y), expected);
+    }
+
+    { // r-values are moved from
+        std::vector<CopyObserver> x{1, 3};
+        std::vector<CopyObserver> y{2, 4};
+        CopyObserver::reset();
+        auto result = kdalgorithms::merged(std::move(x), std::move(y));
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result.size(), 4);
+        QCOMPARE(result[1].value, 2);
+
+        std::vector<std::vector<CopyObserver>> containers(2);
+        containers[0].emplace_back(5);
+        containers[1].emplace_back(4);
+        CopyObserver::reset();
+        result = kdalgorithms::merged(std::move(containers));
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result[0].value, 4);
+    }
+}
+
+void TestAlgorithms::mergedBy()
+{
+    std::vector<std::vector<Struct>> containers{{{1, 4}, {3, 2}}, {{2, 3}, {4, 1}}};
+    auto result = kdalgorithms::merged_by(containers, &Struct::key);
+    std::vector<Struct> expected{{1, 4}, {2, 3}, {3, 2}, {4, 1}};
+    QCOMPARE(result, expected);
+
+    // The values are sorted in descending order in the same containers
+    result = kdalgorithms::merged_by(containers, &Struct::value, kdalgorithms::descending);
+    QCOMPARE(result, expected);
+}
+
 void TestAlgorithms::is_sorted()
 {
     {
@@ -1254,6 +1829,60 @@ void TestAlgorithms::value_in()
     QCOMPARE(result, true);
 }
 
+void TestAlgorithms::static_set()
+{
+    enum Token { If, Else, While, For, Do, Switch, Case, Return, Break };
+
+    {
+        constexpr auto loops = kdalgorithms::make_static_set(While, For, Do);
+        static_assert(kdalgorithms::value_in(For, loops), "Should be evaluated at compile time");
+        static_assert(!kdalgorithms::value_in(If, loops), "Should be evaluated at compile time");
+        QCOMPARE(loops.size(), 3);
+
+        Token token = Do;
+        QVERIFY(kdalgorithms::value_in(token, loops));
+        QVERIFY(kdalgorithms::contains(loops, token));
+        token = Return;
+        QVERIFY(!kdalgorithms::value_in(token, loops));
+        QVERIFY(!kdalgorithms::contains(loops, token));
+    }
+
+    { // All sizes, with the values given in reverse order
+        const auto check = [](const auto &set) {
+            for (int i = -1; i <= int(set.size()) * 2 + 1; ++i)
+                QCOMPARE(kdalgorithms::value_in(i, set),
+                         i % 2 == 0 && i >= 0 && i < int(set.size()) * 2);
+        };
+        check(kdalgorithms::make_static_set(0));
+        check(kdalgorithms::make_static_set(2, 0));
+        check(kdalgorithms::make_static_set(4, 2, 0));
+        check(kdalgorithms::make_static_set(6, 4, 2, 0));
+        check(kdalgorithms::make_static_set(8, 6, 4, 2, 0));
+        check(kdalgorithms::make_static_set(14, 12, 10, 8, 6, 4, 2, 0));
+        check(kdalgorithms::make_static_set(16, 14, 12, 10, 8, 6, 4, 2, 0));
+    }
+
+    {
+        const auto set = kdalgorithms::make_static_set(3, 1, 3, 2);
+        QVERIFY(kdalgorithms::value_in(3, set));
+        QVERIFY(kdalgorithms::value_in(1, set));
+        QVERIFY(!kdalgorithms::value_in(4, set));
+        std::vector<int> expected{1, 2, 3, 3};
+        QCOMPARE(std::vector<int>(set.begin(), set.end()), expected);
+        QCOMPARE(kdalgorithms::count(set, 3), 1);
+    }
+
+    { // Values which aren't representable in the item type aren't converted to it
+        constexpr auto set = kdalgorithms::make_static_set(1, 2, 3);
+        static_assert(!kdalgorithms::value_in(3.5, set), "Should be evaluated at compile time");
+        static_assert(kdalgorithms::value_in(3.0, set), "Should be evaluated at compile time");
+        QVERIFY(!kdalgorithms::contains(set, 3.5));
+        QVERIFY(!set.contains(2.5));
+        QVERIFY(set.find(2.5) == set.end());
+        QVERIFY(kdalgorithms::value_in(2L, set));
+    }
+}
+
 void TestAlgorithms::count()
 {
     std::vector<int> vec{1, 2, 1, 3, 2, 1, 5};
@@ -1261,6 +1890,149 @@ void TestAlgorithms::count()
     QCOMPARE(result, 3);
 }
 
+void TestAlgorithms::associativeLookup()
+{
+    {
+        std::set<int> set{1, 3, 5};
+        QCOMPARE(kdalgorithms::contains(set, 3), true);
+        QCOMPARE(kdalgorithms::contains(set, 4), false);
+        QCOMPARE(kdalgorithms::count(set, 5), 1);
+        QCOMPARE(kdalgorithms::count(set, 4), 0);
+        QCOMPARE(kdalgorithms::erase(set, 3), 1);
+        QCOMPARE(kdalgorithms::erase(set, 3), 0);
+        std::set<int> expected{1, 5};
+        QCOMPARE(set, expected);
+    }
+
+    {
+        std::multiset<int> set{1, 3, 3, 5};
+        QCOMPARE(kdalgorithms::count(set, 3), 2);
+        QCOMPARE(kdalgorithms::erase(set, 3), 2);
+        QCOMPARE(kdalgorithms::contains(set, 3), false);
+    }
+
+    {
+        std::unordered_set<std::string> set{"abc", "def"};
+        QCOMPARE(kdalgorithms::contains(set, "abc"), true);
+        QCOMPARE(kdalgorithms::contains(set, std::string("xyz")), false);
+        QCOMPARE(kdalgorithms::count(set, "def"), 1);
+    }
+
+    {
+        QSet<int> set{1, 3, 5};
+        QCOMPARE(kdalgorithms::contains(set, 3), true);
+        QCOMPARE(kdalgorithms::contains(set, 4), false);
+        QCOMPARE(kdalgorithms::count(set, 3), 1);
+        QCOMPARE(kdalgorithms::erase(set, 3), 1);
+        QCOMPARE(kdalgorithms::erase(set, 3), 0);
+        QCOMPARE(set, (QSet<int>{1, 5}));
+    }
+
+    {
+        using Map = std::map<int, std::string>;
+        Map map{{1, "abc"}, {2, "def"}};
+        QCOMPARE(kdalgorithms::contains(map, Map::value_type{1, "abc"}), true);
+        QCOMPARE(kdalgorithms::contains(map, Map::value_type{1, "def"}), false);
+        QCOMPARE(kdalgorithms::count(map, Map::value_type{2, "def"}), 1);
+        QCOMPARE(kdalgorithms::erase(map, Map::value_type{2, "xyz"}), 0);
+        QCOMPARE(kdalgorithms::erase(map, Map::value_type{2, "def"}), 1);
+        Map expected{{1, "abc"}};
+        QCOMPARE(map, expected);
+    }
+
+    {
+        using Map = std::unordered_multimap<int, int>;
+        Map map{{1, 1}, {1, 2}, {1, 1}, {2, 1}};
+        QCOMPARE(kdalgorithms::count(map, Map::value_type{1, 1}), 2);
+        QCOMPARE(kdalgorithms::erase(map, Map::value_type{1, 1}), 2);
+        QCOMPARE(kdalgorithms::contains(map, Map::value_type{1, 1}), false);
+        QCOMPARE(kdalgorithms::contains(map, Map::value_type{1, 2}), true);
+    }
+
+    // The lookup converts to the key type, which must not make 3.5 match 3
+    {
+        std::set<int> set{3};
+        QCOMPARE(kdalgorithms::contains(set, 3.5), false);
+        QCOMPARE(kdalgorithms::count(set, 3.5), 0);
+        QCOMPARE(kdalgorithms::erase(set, 3.5), 0);
+        QCOMPARE(kdalgorithms::contains(set, 3.0), true);
+        QCOMPARE(set, std::set<int>{3});
+
+        std::unordered_set<int> unorderedSet{3};
+        QCOMPARE(kdalgorithms::contains(unorderedSet, 3.5), false);
+        QCOMPARE(kdalgorithms::count(unorderedSet, 3.5), 0);
+        QCOMPARE(kdalgorithms::erase(unorderedSet, 3.5), 0);
+        QCOMPARE(kdalgorithms::contains(unorderedSet, 3L), true);
+    }
+
+    // Custom comparators may consider items equivalent which aren't equal, so the items are
+    // compared using operator== as for other containers.
+    {
+        auto sameTens = [](int x, int y) { return x / 10 < y / 10; };
+        std::set<int, decltype(sameTens)> set({15, 27}, sameTens);
+        QCOMPARE(kdalgorithms::contains(set, 12), false);
+        QCOMPARE(kdalgorithms::contains(set, 15), true);
+        QCOMPARE(kdalgorithms::count(set, 12), 0);
+        QCOMPARE(kdalgorithms::erase(set, 21), 0);
+        QCOMPARE(kdalgorithms::erase(set, 27), 1);
+        QCOMPARE(set.size(), 1);
+    }
+}
+
+void TestAlgorithms::contiguousSearch()
+{
+    // Compare the search kernels to the generic algorithms for all positions of the needle,
+    // including the tail which isn't handled in blocks.
+    const auto check = [](auto container) {
+        using T = kdalgorithms::ValueType<decltype(container)>;
+        for (std::size_t i = 0; i < container.size(); ++i)
+            container[i] = static_cast<T>(i % 100);
+        for (int needle = -1; needle <= 101; ++needle) {
+            QCOMPARE(kdalgorithms::contains(container, needle),
+                     std::find(container.cbegin(), container.cend(), needle) != container.cend());
+            QCOMPARE(kdalgorithms::count(container, needle),
+                     int(std::count(container.cbegin(), container.cend(), needle)));
+        }
+    };
+    check(std::vector<char>(300));
+    check(std::vector<unsigned char>(5));
+    check(std::vector<std::int16_t>(170));
+    check(std::vector<char16_t>(33));
+    check(std::vector<char16_t>(300));
+    check(std::vector<int>(250));
+    check(std::vector<std::uint64_t>(17));
+    check(std::vector<wchar_t>(120));
+    check(std::array<int, 3>());
+    check(std::string(150, ' '));
+
+    { // Values which can't be represented in the item type never match
+        std::vector<unsigned char> bytes{0, 44, 255};
+        QCOMPARE(kdalgorithms::contains(bytes, 300), false);
+        QCOMPARE(kdalgorithms::contains(bytes, -1), false);
+        QCOMPARE(kdalgorithms::count(bytes, 255), 1);
+
+        std::vector<unsigned int> uints{0, 0xFFFFFFFF};
+        QCOMPARE(kdalgorithms::contains(uints, -1),
+                 std::find(uints.cbegin(), uints.cend(), -1) != uints.cend());
+    }
+
+    {
+        QByteArray bytes("hello world");
+        QCOMPARE(kdalgorithms::contains(bytes, 'w'), true);
+        QCOMPARE(kdalgorithms::count(bytes, 'o'), 2);
+    }
+
+    { // QChar is searched as char16_t
+        QString text = QString("hello world ").repeated(20);
+        QCOMPARE(kdalgorithms::contains(text, QChar('w')), true);
+        QCOMPARE(kdalgorithms::contains(text, QChar('x')), false);
+        QCOMPARE(kdalgorithms::count(text, QChar('o')), 40);
+    }
+
+    QCOMPARE(kdalgorithms::contains(emptyIntVector, 0), false);
+    QCOMPARE(kdalgorithms::count(emptyIntVector, 0), 0);
+}
+
 void TestAlgorithms::count_if()
 {
     {
@@ -1285,6 +2057,68 @@ void TestAlgorithms::count_if()
     }
 }
 
+void TestAlgorithms::sorted_lookup()
+{
+    std::vector<int> vec{1, 2, 2, 2, 5, 7};
+    QCOMPARE(kdalgorithms::sorted_contains(vec, 5), true);
+    QCOMPARE(kdalgorithms::sorted_contains(vec, 3), false);
+    QCOMPARE(kdalgorithms::sorted_contains(vec, 8), false);
+    QCOMPARE(kdalgorithms::sorted_contains(emptyIntVector, 1), false);
+
+    QCOMPARE(kdalgorithms::sorted_count(vec, 2), 3);
+    QCOMPARE(kdalgorithms::sorted_count(vec, 3), 0);
+
+    QCOMPARE(kdalgorithms::sorted_index_of(vec, 2), 1);
+    QCOMPARE(kdalgorithms::sorted_index_of(vec, 7), 5);
+    QCOMPARE(kdalgorithms::sorted_index_of(vec, 0), -1);
+    QCOMPARE(kdalgorithms::sorted_index_of(vec, 6), -1);
+
+    // Custom sort order
+    std::vector<Struct> structs{{4, 1}, {3, 2}, {2, 3}, {1, 4}};
+    auto compare = [](const Struct &x, const Struct &y) { return x.key > y.key; };
+    QCOMPARE(kdalgorithms::sorted_contains(structs, Struct{2, 0}, compare), true);
+    QCOMPARE(kdalgorithms::sorted_index_of(structs, Struct{2, 0}, compare), 2);
+    QCOMPARE(kdalgorithms::sorted_count(structs, Struct{5, 0}, compare), 0);
+}
+
+void TestAlgorithms::eytzinger_index()
+{
+    {
+        auto index = kdalgorithms::make_eytzinger_index(unsortedIntVector);
+        QCOMPARE(index.size(), 5);
+        for (int i : unsortedIntVector)
+            QVERIFY(index.contains(i));
+        for (int i : {-1, 0, 1, 4, 5, 7, 9, 10, 12})
+            QVERIFY(!index.contains(i));
+    }
+
+    { // All sizes, to cover complete as well as partial trees
+        for (int size = 0; size < 40; ++size) {
+            auto evens = kdalgorithms::transformed(kdalgorithms::iota(size),
+                                                   [](int i) { return i * 2; });
+            auto index = kdalgorithms::make_eytzinger_index(evens);
+            QCOMPARE(index.empty(), size == 0);
+            for (int i = -1; i <= 2 * size; ++i)
+                QCOMPARE(index.contains(i), i >= 0 && i % 2 == 0 && i < 2 * size);
+        }
+    }
+
+    { // Duplicates, and a custom compare
+        std::vector<int> vec{5, 1, 5, 3, 1};
+        auto index = kdalgorithms::make_eytzinger_index(vec, std::greater<int>());
+        QCOMPARE(index.size(), 3);
+        QVERIFY(index.contains(3));
+        QVERIFY(!index.contains(4));
+    }
+
+    {
+        std::vector<QString> words{"def", "abc", "hij"};
+        auto index = kdalgorithms::make_eytzinger_index(words);
+        QVERIFY(index.contains("abc"));
+        QVERIFY(!index.contains("xyz"));
+    }
+}
+
 void TestAlgorithms::max_value()
 {
 #if __cplusplus >= 201703L
@@ -1293,55 +2127,194 @@ void TestAlgorithms::max_value()
         auto result = kdalgorithms::max_value(unsortedIts, std::less<int>());
         QCOMPARE(result.value(), 4);
 
-        result = kdalgorithms::max_value(unsortedIts, std::greater<int>());
-        QCOMPARE(result.value(), 1);
+        result = kdalgorithms::max_value(unsortedIts, std::greater<int>());
+        QCOMPARE(result.value(), 1);
+
+        result = kdalgorithms::max_value(emptyIntVector, std::less<int>());
+        QVERIFY(!result.has_value());
+
+        result = kdalgorithms::max_value(unsortedIts);
+        QCOMPARE(result.value(), 4);
+    }
+
+    {
+        auto result = kdalgorithms::max_value(structVec, &Struct::lessThanByXY);
+        Struct expected{4, 1};
+        QCOMPARE(*result, expected);
+    }
+
+    {
+        std::map<int, int> map{{1, 1}, {2, 3}, {4, 2}};
+        auto lessthan = [](auto x, auto y) { return x.second < y.second; };
+        auto result = kdalgorithms::max_value(map, lessthan);
+        std::pair<const int, int> expected{2, 3};
+        QCOMPARE(*result, expected);
+    }
+#endif
+}
+
+void TestAlgorithms::min_value()
+{
+#if __cplusplus >= 201703L
+    {
+        auto result = kdalgorithms::min_value(intVector, std::less<int>());
+        QCOMPARE(result.value(), 1);
+
+        result = kdalgorithms::min_value(intVector, std::greater<int>());
+        QCOMPARE(result.value(), 4);
+
+        result = kdalgorithms::min_value(emptyIntVector, std::less<int>());
+        QVERIFY(!result.has_value());
+
+        result = kdalgorithms::min_value(intVector);
+        QCOMPARE(result.value(), 1);
+    }
+
+    {
+        auto result = kdalgorithms::min_value(structVec, &Struct::lessThanByXY);
+        Struct expected{1, 4};
+        QCOMPARE(*result, expected);
+    }
+#endif
+}
+
+void TestAlgorithms::minmax_value()
+{
+#if __cplusplus >= 201703L
+    {
+        std::vector<int> unsortedInts{4, 1, 3, 2};
+        auto result = kdalgorithms::minmax_value(unsortedInts);
+        QCOMPARE(result->min, 1);
+        QCOMPARE(result->max, 4);
+
+        result = kdalgorithms::minmax_value(unsortedInts, std::greater<int>());
+        QCOMPARE(result->min, 4);
+        QCOMPARE(result->max, 1);
+
+        result = kdalgorithms::minmax_value(emptyIntVector);
+        QVERIFY(!result.has_value());
+    }
+
+    {
+        std::deque<int> deque{7};
+        auto result = kdalgorithms::minmax_value(deque);
+        QCOMPARE(result->min, 7);
+        QCOMPARE(result->max, 7);
+    }
+
+    {
+        auto result = kdalgorithms::minmax_value(unsortedStructVec, &Struct::lessThanByXY);
+        Struct expectedMin{1, 3};
+        Struct expectedMax{5, 4};
+        QCOMPARE(result->min, expectedMin);
+        QCOMPARE(result->max, expectedMax);
+    }
+#endif
+}
+
+void TestAlgorithms::minmax_by()
+{
+    {
+        auto result = kdalgorithms::minmax_by(unsortedStructVec, &Struct::value);
+        QVERIFY(result.min);
+        QVERIFY(result.max);
+        Struct expectedMin{3, 1};
+        QCOMPARE(*result.min, expectedMin);
+        QCOMPARE(result.max->value, 4);
+        // No copies - the result refers into the container
+        QCOMPARE(&*result.min, &unsortedStructVec[3]);
+    }
+
+    {
+        auto result = kdalgorithms::minmax_by(emptyIntVector, [](int i) { return -i; });
+        QVERIFY(!result.min);
+        QVERIFY(!result.max);
+    }
+
+    {
+        std::vector<Person> people{{"Jesper", 52}, {"Ivan", 42}, {"Kalle", 53}};
+        auto result = kdalgorithms::minmax_by(people, &Person::age);
+        QCOMPARE(result.min->name, QString("Ivan"));
+        QCOMPARE(result.max->name, QString("Kalle"));
+    }
+}
+
+void TestAlgorithms::min_max_index()
+{
+    std::vector<int> unsortedInts{4, 1, 3, 2};
+    QCOMPARE(kdalgorithms::min_index(unsortedInts), 1);
+    QCOMPARE(kdalgorithms::max_index(unsortedInts), 0);
+    QCOMPARE(kdalgorithms::max_index(unsortedInts, std::greater<int>()), 1);
+    QCOMPARE(kdalgorithms::min_index(emptyIntVector), -1);
+    QCOMPARE(kdalgorithms::max_index(emptyIntVector), -1);
+
+    QCOMPARE(kdalgorithms::max_index(unsortedStructVec, &Struct::lessThanByXY), 4);
+}
+
+void TestAlgorithms::min_max_ref()
+{
+    {
+        auto result = kdalgorithms::max_ref(unsortedIntVector);
+        QVERIFY(result);
+        QCOMPARE(*result, 11);
+        QCOMPARE(&*result, &unsortedIntVector[4]);
+
+        result = kdalgorithms::min_ref(unsortedIntVector);
+        QCOMPARE(*result, 2);
 
-        result = kdalgorithms::max_value(emptyIntVector, std::less<int>());
-        QVERIFY(!result.has_value());
+        QVERIFY(!kdalgorithms::min_ref(emptyIntVector));
+        QVERIFY(!kdalgorithms::max_ref(emptyIntVector));
+    }
 
-        result = kdalgorithms::max_value(unsortedIts);
-        QCOMPARE(result.value(), 4);
+    { // The result is fine to use even for temporaries
+        auto result = kdalgorithms::max_ref(getStruct(), &Struct::lessThanByXY);
+        Struct expected{4, 4};
+        QVERIFY(result.has_result());
+        QCOMPARE(*result, expected);
     }
 
     {
-        auto result = kdalgorithms::max_value(structVec, &Struct::lessThanByXY);
-        Struct expected{4, 1};
-        QCOMPARE(*result, expected);
+        std::vector<int> vec{1, 5, 2};
+        auto result = kdalgorithms::max_ref(vec);
+        *result = 0;
+        std::vector<int> expected{1, 0, 2};
+        QCOMPARE(vec, expected);
     }
 
     {
         std::map<int, int> map{{1, 1}, {2, 3}, {4, 2}};
-        auto lessthan = [](auto x, auto y) { return x.second < y.second; };
-        auto result = kdalgorithms::max_value(map, lessthan);
-        std::pair<const int, int> expected{2, 3};
-        QCOMPARE(*result, expected);
+        auto result = kdalgorithms::max_ref(
+            map, [](const auto &x, const auto &y) { return x.second < y.second; });
+        QCOMPARE(result->first, 2);
     }
-#endif
 }
 
-void TestAlgorithms::min_value()
+void TestAlgorithms::min_max_by()
 {
-#if __cplusplus >= 201703L
     {
-        auto result = kdalgorithms::min_value(intVector, std::less<int>());
-        QCOMPARE(result.value(), 1);
+        auto result = kdalgorithms::max_by(unsortedStructVec, &Struct::value);
+        Struct expected{2, 4};
+        QCOMPARE(*result, expected);
 
-        result = kdalgorithms::min_value(intVector, std::greater<int>());
-        QCOMPARE(result.value(), 4);
+        result = kdalgorithms::min_by(unsortedStructVec, &Struct::sumPairs);
+        expected = {1, 3};
+        QCOMPARE(*result, expected);
 
-        result = kdalgorithms::min_value(emptyIntVector, std::less<int>());
-        QVERIFY(!result.has_value());
+        QVERIFY(!kdalgorithms::max_by(emptyIntVector, [](int i) { return -i; }));
+    }
 
-        result = kdalgorithms::min_value(intVector);
-        QCOMPARE(result.value(), 1);
+    {
+        std::vector<Person> people{{"Jesper", 52}, {"Ivan", 42}, {"Kalle", 53}};
+        auto result = kdalgorithms::min_by(people, &Person::age);
+        QCOMPARE(result->name, QString("Ivan"));
+        QCOMPARE(&*result, &people[1]);
     }
 
     {
-        auto result = kdalgorithms::min_value(structVec, &Struct::lessThanByXY);
-        Struct expected{1, 4};
-        QCOMPARE(*result, expected);
+        auto result = kdalgorithms::max_by(std::vector<Person>{{"Jesper", 52}, {"Kalle", 53}},
+                                           [](const Person &person) { return person.name; });
+        QCOMPARE(result->name, QString("Kalle"));
     }
-#endif
 }
 
 void TestAlgorithms::maxValueLessThan()
@@ -1519,6 +2492,82 @@ void TestAlgorithms::isPermutation()
     QVERIFY(!kdalgorithms::is_permutation(v1, v2, &Struct::hasEqualValues));
 }
 
+void TestAlgorithms::isPermutationLarge()
+{
+    std::vector<int> ints(1000);
+    for (int i = 0; i < 1000; ++i)
+        ints[i] = i % 300;
+    auto reversedInts = kdalgorithms::reversed(ints);
+
+    { // hashable
+        QVERIFY(kdalgorithms::is_permutation(ints, reversedInts));
+        auto other = reversedInts;
+        other[10] = 299; // Same items, but with different counts
+        QVERIFY(!kdalgorithms::is_permutation(ints, other));
+        other.push_back(10);
+        QVERIFY(!kdalgorithms::is_permutation(ints, other));
+    }
+
+    { // Only differs after a long common prefix
+        auto other = ints;
+        std::swap(other[900], other[999]);
+        QVERIFY(kdalgorithms::is_permutation(ints, other));
+        other[999] = 1000;
+        QVERIFY(!kdalgorithms::is_permutation(ints, other));
+    }
+
+    { // operator< but no std::hash
+        using Pair = std::pair<int, int>;
+        auto toPair = [](int i) { return Pair{i % 7, i}; };
+        auto pairs = kdalgorithms::transformed(ints, toPair);
+        auto reversedPairs = kdalgorithms::transformed(reversedInts, toPair);
+        QVERIFY(kdalgorithms::is_permutation(pairs, reversedPairs));
+        reversedPairs[500].second = -1;
+        QVERIFY(!kdalgorithms::is_permutation(pairs, reversedPairs));
+    }
+
+    { // operator< only orders by part of what operator== compares
+        struct Item
+        {
+            int key;
+            int extra;
+            bool operator<(const Item &other) const { return key < other.key; }
+            bool operator==(const Item &other) const
+            {
+                return key == other.key && extra == other.extra;
+            }
+        };
+        auto toItem = [](int i) { return Item{i % 3, i}; };
+        auto items = kdalgorithms::transformed(ints, toItem);
+        auto reversedItems = kdalgorithms::transformed(reversedInts, toItem);
+        QVERIFY(kdalgorithms::is_permutation(items, reversedItems));
+        reversedItems[500].extra = -1;
+        QVERIFY(!kdalgorithms::is_permutation(items, reversedItems));
+    }
+
+    { // Custom compare
+        auto onKey = [](Struct x, Struct y) { return x.key == y.key; };
+        auto toStruct = [](int i) { return Struct{i, -i}; };
+        auto structs = kdalgorithms::transformed(ints, toStruct);
+        auto reversedStructs = kdalgorithms::transformed(reversedInts, toStruct);
+        reversedStructs[0].value = 42;
+        QVERIFY(kdalgorithms::is_permutation(structs, reversedStructs, onKey));
+        QVERIFY(kdalgorithms::is_permutation(structs, reversedStructs, &Struct::hasEqualKeys));
+        QVERIFY(!kdalgorithms::is_permutation(structs, reversedStructs,
+                                              &Struct::hasEqualValues));
+    }
+
+    { // Iterators returning proxies rather than references
+        std::vector<bool> bools(200);
+        for (std::size_t i = 0; i < bools.size(); ++i)
+            bools[i] = i % 3 == 0;
+        std::vector<bool> reversedBools(bools.rbegin(), bools.rend());
+        QVERIFY(kdalgorithms::is_permutation(bools, reversedBools));
+        reversedBools[1].flip();
+        QVERIFY(!kdalgorithms::is_permutation(bools, reversedBools));
+    }
+}
+
 void TestAlgorithms::accumulate()
 {
     // No function provided
@@ -1857,6 +2906,87 @@ void TestAlgorithms::sum_if()
     }
 }
 
+void TestAlgorithms::scans()
+{
+    const std::vector<int> vec{1, 2, 3, 4};
+    QCOMPARE(kdalgorithms::inclusive_scanned(vec), std::vector<int>({1, 3, 6, 10}));
+    QCOMPARE(kdalgorithms::exclusive_scanned(vec), std::vector<int>({0, 1, 3, 6}));
+    QCOMPARE(kdalgorithms::exclusive_scanned(vec, std::plus<int>(), 10),
+             std::vector<int>({10, 11, 13, 16}));
+    QCOMPARE(kdalgorithms::inclusive_scanned(vec, std::multiplies<int>()),
+             std::vector<int>({1, 2, 6, 24}));
+
+    { // in place
+        auto copy = vec;
+        kdalgorithms::inclusive_scan(copy);
+        QCOMPARE(copy, std::vector<int>({1, 3, 6, 10}));
+        copy = vec;
+        kdalgorithms::exclusive_scan(copy, [](int x, int y) { return std::max(x, y); }, 2);
+        QCOMPARE(copy, std::vector<int>({2, 2, 2, 3}));
+    }
+
+    { // other containers
+        std::list<QString> list{"a", "b", "c"};
+        QCOMPARE(kdalgorithms::inclusive_scanned(list), std::list<QString>({"a", "ab", "abc"}));
+        QCOMPARE(kdalgorithms::exclusive_scanned(list), std::list<QString>({"", "a", "ab"}));
+
+        std::vector<int> empty;
+        QVERIFY(kdalgorithms::inclusive_scanned(empty).empty());
+        QVERIFY(kdalgorithms::exclusive_scanned(empty).empty());
+    }
+
+    { // r-values are moved from
+        std::vector<QString> strings{"a", "b", "c"};
+        auto result = kdalgorithms::inclusive_scanned(std::move(strings));
+        QCOMPARE(result, std::vector<QString>({"a", "ab", "abc"}));
+    }
+}
+
+void TestAlgorithms::scansWithProjection()
+{
+    struct Record
+    {
+        QString name;
+        int size;
+    };
+    std::vector<Record> records{{"header", 16}, {"body", 100}, {"footer", 8}};
+
+    auto offsets = kdalgorithms::exclusive_scanned_by(records, &Record::size);
+    QCOMPARE(offsets, std::vector<int>({0, 16, 116}));
+
+    auto ends = kdalgorithms::inclusive_scanned_by(records, &Record::size);
+    QCOMPARE(ends, std::vector<int>({16, 116, 124}));
+
+    auto sizes = kdalgorithms::inclusive_scanned_by(
+        records, [](const Record &record) { return record.name.size(); });
+    QCOMPARE(sizes.back(), 16);
+}
+
+void TestAlgorithms::parallelScans()
+{
+    std::vector<int> vec(100000);
+    for (int i = 0; i < static_cast<int>(vec.size()); ++i)
+        vec[i] = i % 7 - 3;
+
+    auto expectedInclusive = kdalgorithms::inclusive_scanned(vec);
+    auto expectedExclusive = kdalgorithms::exclusive_scanned(vec, std::plus<int>(), 5);
+    QCOMPARE(kdalgorithms::parallel_inclusive_scanned(vec), expectedInclusive);
+    QCOMPARE(kdalgorithms::parallel_exclusive_scanned(vec, std::plus<int>(), 5),
+             expectedExclusive);
+
+    auto copy = vec;
+    kdalgorithms::parallel_inclusive_scan(copy);
+    QCOMPARE(copy, expectedInclusive);
+
+    std::vector<int> small{1, 2, 3};
+    QCOMPARE(kdalgorithms::parallel_exclusive_scanned(small), std::vector<int>({0, 1, 3}));
+    std::vector<int> empty;
+    QVERIFY(kdalgorithms::parallel_inclusive_scanned(empty).empty());
+
+    std::list<int> list{1, 2, 3};
+    QCOMPARE(kdalgorithms::parallel_inclusive_scanned(list), std::list<int>({1, 3, 6}));
+}
+
 void TestAlgorithms::get_match()
 {
 #if __cplusplus >= 201703L
@@ -2049,6 +3179,91 @@ void TestAlgorithms::erase_if()
     }
 }
 
+void TestAlgorithms::branchlessCompaction()
+{
+    std::vector<int> vec{5, 2, 8, 1, 9, 4, 7, 6, 3};
+    const auto isOdd = [](int i) { return i % 2 == 1; };
+    const std::vector<int> odd{5, 1, 9, 7, 3};
+    const std::vector<int> even{2, 8, 4, 6};
+
+    for (auto option : {kdalgorithms::compact_branching, kdalgorithms::compact_branchless}) {
+        QCOMPARE(kdalgorithms::filtered(vec, isOdd, option), odd);
+        QCOMPARE(kdalgorithms::filtered<QVector>(vec, isOdd, option),
+                 (QVector<int>{5, 1, 9, 7, 3}));
+        QCOMPARE(kdalgorithms::filtered(std::vector<int>(vec), isOdd, option), odd);
+        QCOMPARE(kdalgorithms::filtered(std::vector<int>{}, isOdd, option), std::vector<int>{});
+
+        auto copy = vec;
+        kdalgorithms::filter(copy, isOdd, option);
+        QCOMPARE(copy, odd);
+
+        copy = vec;
+        auto count = kdalgorithms::erase_if(copy, isOdd, option);
+        QCOMPARE(copy, even);
+        QCOMPARE(count, 5);
+
+        std::vector<Struct> structs{{2, 3}, {1, 1}, {2, 2}, {4, 1}};
+        count = kdalgorithms::erase_if(structs, &Struct::hasEqualKeyValuePair, option);
+        QCOMPARE(structs, (std::vector<Struct>{{2, 3}, {4, 1}}));
+        QCOMPARE(count, 2);
+
+        std::vector<int> empty;
+        QCOMPARE(kdalgorithms::erase_if(empty, isOdd, option), 0);
+
+        // Not contiguous respectively not trivially copyable, so the option is ignored
+        std::list<int> list(vec.begin(), vec.end());
+        kdalgorithms::filter(list, isOdd, option);
+        QCOMPARE(list, (std::list<int>(odd.begin(), odd.end())));
+
+        std::vector<QString> strings{"a", "bb", "c"};
+        kdalgorithms::erase_if(
+            strings, [](const QString &str) { return str.size() == 1; }, option);
+        QCOMPARE(strings, std::vector<QString>{"bb"});
+    }
+}
+
+void TestAlgorithms::selectIndicesAndMasks()
+{
+    using namespace kdalgorithms::operators;
+    const std::vector<int> ages{12, 45, 31, 8, 67};
+    const std::vector<QString> names{"Ann", "Bob", "Cid", "Dan", "Eve"};
+    const auto isAdult = [](int age) { return age >= 18; };
+    const auto isOld = [](int age) { return age > 60; };
+
+    {
+        auto indices = kdalgorithms::select_indices(ages, isAdult && !isOld);
+        QCOMPARE(indices, (std::vector<std::size_t>{1, 2}));
+        QCOMPARE(kdalgorithms::gather(ages, indices), (std::vector<int>{45, 31}));
+        QCOMPARE(kdalgorithms::gather(names, indices), (std::vector<QString>{"Bob", "Cid"}));
+
+        // Any order, and repeated indexes
+        QCOMPARE(kdalgorithms::gather(names, std::vector<int>{4, 0, 4}),
+                 (std::vector<QString>{"Eve", "Ann", "Eve"}));
+    }
+
+    {
+        auto mask = kdalgorithms::select_mask(ages, isAdult);
+        QCOMPARE(mask, (std::vector<bool>{false, true, true, false, true}));
+        QCOMPARE(kdalgorithms::apply_mask(ages, mask), (std::vector<int>{45, 31, 67}));
+        QCOMPARE(kdalgorithms::apply_mask(names, mask),
+                 (std::vector<QString>{"Bob", "Cid", "Eve"}));
+
+        std::vector<std::unique_ptr<int>> pointers;
+        for (int age : ages)
+            pointers.push_back(std::make_unique<int>(age));
+        auto result = kdalgorithms::apply_mask(std::move(pointers), mask);
+        QCOMPARE(result.size(), 3);
+        QCOMPARE(*result[2], 67);
+    }
+
+    {
+        const std::vector<int> empty;
+        QVERIFY(kdalgorithms::select_indices(empty, isAdult).empty());
+        QVERIFY(kdalgorithms::select_mask(empty, isAdult).empty());
+        QVERIFY(kdalgorithms::select_indices(ages, [](int) { return false; }).empty());
+    }
+}
+
 void TestAlgorithms::combiningTests()
 {
     using namespace kdalgorithms::operators;
@@ -2731,6 +3946,368 @@ void TestAlgorithms::zip()
     }
 }
 
+void TestAlgorithms::unzipped()
+{
+    std::vector<std::tuple<int, QString, double>> rows{{1, "one", 1.5}, {2, "two", 2.5}};
+    auto columns = kdalgorithms::unzipped(rows);
+    QCOMPARE(std::get<0>(columns), std::vector<int>({1, 2}));
+    QCOMPARE(std::get<1>(columns), std::vector<QString>({"one", "two"}));
+    QCOMPARE(std::get<2>(columns), std::vector<double>({1.5, 2.5}));
+    QCOMPARE(std::get<1>(columns).capacity(), 2u);
+
+    { // pairs, and another result container
+        std::map<int, QString> map{{1, "one"}, {2, "two"}};
+        auto result = kdalgorithms::unzipped<std::deque>(map);
+        QCOMPARE(std::get<0>(result), std::deque<int>({1, 2}));
+        QCOMPARE(std::get<1>(result), std::deque<QString>({"one", "two"}));
+    }
+
+    { // zip and unzip are opposites
+        std::vector<int> ints{1, 2, 3};
+        std::vector<char> chars{'a', 'b', 'c'};
+        auto result = kdalgorithms::unzipped(kdalgorithms::zip(ints, chars));
+        QCOMPARE(std::get<0>(result), ints);
+        QCOMPARE(std::get<1>(result), chars);
+    }
+
+    { // r-values are moved from
+        std::vector<std::pair<std::unique_ptr<int>, int>> pairs;
+        pairs.emplace_back(std::make_unique<int>(42), 1);
+        auto result = kdalgorithms::unzipped(std::move(pairs));
+        QCOMPARE(*std::get<0>(result)[0], 42);
+    }
+}
+
+void TestAlgorithms::unzippedWithProjections()
+{
+    std::vector<Person> people{{"Jesper", 52}, {"Ivan", 42}, {"Till", 44}};
+    auto columns = kdalgorithms::unzipped(people, &Person::name, &Person::age,
+                                          [](const Person &p) { return p.age >= 44; });
+    QCOMPARE(std::get<0>(columns), std::vector<QString>({"Jesper", "Ivan", "Till"}));
+    QCOMPARE(std::get<1>(columns), std::vector<int>({52, 42, 44}));
+    QCOMPARE(std::get<2>(columns), std::vector<bool>({true, false, true}));
+
+    auto result = kdalgorithms::unzipped<std::list>(people, &Person::age);
+    QCOMPARE(std::get<0>(result), std::list<int>({52, 42, 44}));
+
+    { // Members are moved out of r-values
+        struct Resource
+        {
+            std::unique_ptr<int> handle;
+            int id;
+        };
+        std::vector<Resource> resources;
+        resources.push_back({std::make_unique<int>(7), 1});
+        auto columns =
+            kdalgorithms::unzipped(std::move(resources), &Resource::handle, &Resource::id);
+        QCOMPARE(*std::get<0>(columns)[0], 7);
+        QCOMPARE(std::get<1>(columns)[0], 1);
+    }
+}
+
+void TestAlgorithms::soaView()
+{
+    std::vector<QString> names{"Jesper", "Ivan", "Till", "Kalle"};
+    std::vector<int> ages{52, 42, 44, 53};
+    auto people = kdalgorithms::soa_view(names, ages);
+    QCOMPARE(people.size(), 4u);
+    QCOMPARE(std::get<0>(people[1]), QString("Ivan"));
+
+    // Sorting the view sorts all the columns
+    kdalgorithms::sort_by(people, [](const auto &person) { return std::get<1>(person); });
+    QCOMPARE(names, std::vector<QString>({"Ivan", "Till", "Jesper", "Kalle"}));
+    QCOMPARE(ages, std::vector<int>({42, 44, 52, 53}));
+
+    // Changing the items through the view
+    for (auto person : people)
+        std::get<1>(person) += 1;
+    QCOMPARE(ages, std::vector<int>({43, 45, 53, 54}));
+
+    // Transforming and searching
+    auto ageAndNameLengths = kdalgorithms::transformed<std::vector>(people, [](const auto &person) {
+        return std::get<1>(person) * 100 + static_cast<int>(std::get<0>(person).size());
+    });
+    QCOMPARE(ageAndNameLengths.front(), 4304);
+    auto isTill = [](const auto &person) { return std::get<0>(person) == "Till"; };
+    auto till = kdalgorithms::find_if(people, isTill);
+    QVERIFY(till.has_result());
+    QCOMPARE(std::get<1>(*till), 45);
+
+    // Filtering erases from all the columns
+    kdalgorithms::filter(people, [](const auto &person) { return std::get<1>(person) > 50; });
+    QCOMPARE(names, std::vector<QString>({"Jesper", "Kalle"}));
+    QCOMPARE(ages, std::vector<int>({53, 54}));
+
+    // Filtered copies out of the columns
+    auto old = kdalgorithms::filtered<std::vector>(
+        people, [](const std::tuple<QString, int> &person) { return std::get<1>(person) > 53; });
+    QCOMPARE(old, (std::vector<std::tuple<QString, int>>{{"Kalle", 54}}));
+
+    auto isKalle = [](const auto &person) { return std::get<0>(person) == "Kalle"; };
+    QCOMPARE(kdalgorithms::erase_if(people, isKalle), 1);
+    QCOMPARE(names, std::vector<QString>({"Jesper"}));
+    QCOMPARE(ages, std::vector<int>({53}));
+
+#if __cplusplus >= 201703L
+    auto [name, age] = people[0];
+    QCOMPARE(name, QString("Jesper"));
+    age = 60;
+    QCOMPARE(ages[0], 60);
+#endif
+}
+
+void TestAlgorithms::enumerate()
+{
+    std::vector<QString> vec{"a", "b", "c"};
+
+    {
+        std::vector<std::size_t> indexes;
+        QString values;
+        for (const auto &item : kdalgorithms::enumerate(vec)) {
+            indexes.push_back(item.first);
+            values += item.second;
+        }
+        QCOMPARE(indexes, std::vector<std::size_t>({0, 1, 2}));
+        QCOMPARE(values, QString("abc"));
+    }
+
+    { // The items are references
+        for (auto item : kdalgorithms::enumerate(vec))
+            item.second += QString::number(static_cast<int>(item.first));
+        QCOMPARE(vec, std::vector<QString>({"a0", "b1", "c2"}));
+    }
+
+    { // With the other algorithms
+        auto isOddIndex = [](const auto &item) { return item.first % 2 == 1; };
+        auto result = kdalgorithms::transformed<std::vector>(
+            kdalgorithms::filtered<std::vector>(kdalgorithms::enumerate(vec), isOddIndex),
+            [](const auto &item) { return item.second; });
+        QCOMPARE(result, std::vector<QString>({"b1"}));
+
+        auto isC2 = [](const auto &item) { return item.second == "c2"; };
+        auto found = kdalgorithms::parallel_find_if(kdalgorithms::enumerate(vec), isC2);
+        QVERIFY(found.has_result());
+        QCOMPARE((*found).first, 2u);
+    }
+
+    { // Random access
+        auto view = kdalgorithms::enumerate(vec);
+        auto it = view.begin() + 2;
+        QCOMPARE((*it).second, QString("c2"));
+        QCOMPARE(it - view.begin(), 2);
+        QCOMPARE(view.begin()[1].first, 1u);
+        QCOMPARE(view.size(), 3u);
+    }
+
+    { // std::list
+        std::list<int> list{4, 5, 6};
+        std::size_t sum = 0;
+        for (auto item : kdalgorithms::enumerate(list))
+            sum += item.first * static_cast<std::size_t>(item.second);
+        QCOMPARE(sum, 17u);
+    }
+
+    { // r-values are moved out of
+        std::vector<std::unique_ptr<int>> pointers;
+        pointers.push_back(std::make_unique<int>(1));
+        pointers.push_back(std::make_unique<int>(2));
+        std::vector<std::unique_ptr<int>> result;
+        for (auto item : kdalgorithms::enumerate(std::move(pointers))) {
+            *item.second += static_cast<int>(item.first) * 10;
+            result.push_back(std::move(item.second));
+        }
+        QCOMPARE(*result[1], 12);
+    }
+
+    { // Items of r-values are only moved out when taken, so they may be read several times
+        auto strings = [] { return std::vector<std::string>{"apple", "kiwi", "banana"}; };
+        auto isLong = [](const auto &item) { return item.second.size() > 4; };
+        auto longStrings = kdalgorithms::filtered<std::vector>(
+            kdalgorithms::enumerate(strings()), isLong);
+        QCOMPARE(longStrings,
+                 (std::vector<std::pair<std::size_t, std::string>>{{0, "apple"}, {2, "banana"}}));
+
+        auto longest = kdalgorithms::max_by(kdalgorithms::enumerate(strings()),
+                                            [](const auto &item) { return item.second.size(); });
+        QVERIFY(longest.has_result());
+        QCOMPARE(longest->first, 2u);
+        QCOMPARE(longest->second, std::string("banana"));
+    }
+
+#if __cplusplus >= 201703L
+    for (auto [index, value] : kdalgorithms::enumerate(vec))
+        QCOMPARE(value, vec[index]);
+#endif
+}
+
+void TestAlgorithms::detachAwareRValues()
+{
+    { // Shared r-values are copied from, rather than being detached
+        SharedVector<std::string> vec{"a", "b", "c"};
+        vec.shared = true;
+        auto result = kdalgorithms::transformed<std::vector>(
+            std::move(vec), [](const std::string &s) { return s + s; });
+        QCOMPARE(result, (std::vector<std::string>{"aa", "bb", "cc"}));
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec[1], std::string("b"));
+    }
+
+    { // Unshared r-values are moved from
+        SharedVector<std::string> vec{"a", "b", "c"};
+        auto result = kdalgorithms::copied<std::vector<std::string>>(std::move(vec));
+        QCOMPARE(result, (std::vector<std::string>{"a", "b", "c"}));
+        QVERIFY(vec[1].empty());
+    }
+
+    { // In place transformation of a shared r-value
+        SharedVector<int> vec{1, 2, 3};
+        vec.shared = true;
+        auto result = kdalgorithms::transformed(std::move(vec), squareItem);
+        QCOMPARE(result, (SharedVector<int>{1, 4, 9}));
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec, (SharedVector<int>{1, 2, 3}));
+
+        SharedVector<int> unshared{1, 2, 3};
+        result = kdalgorithms::transformed(std::move(unshared), squareItem);
+        QCOMPARE(result, (SharedVector<int>{1, 4, 9}));
+    }
+
+    { // filtered_transformed
+        SharedVector<int> vec{1, 2, 3, 4};
+        vec.shared = true;
+        auto result = kdalgorithms::filtered_transformed(std::move(vec), squareItem, isOdd);
+        QCOMPARE(result, (SharedVector<int>{1, 9}));
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec.size(), 4u);
+
+        SharedVector<int> unshared{1, 2, 3, 4};
+        result = kdalgorithms::filtered_transformed(std::move(unshared), squareItem, isOdd);
+        QCOMPARE(result, (SharedVector<int>{1, 9}));
+    }
+
+    { // filtered and copied
+        SharedVector<std::string> vec{"a", "bb", "c"};
+        vec.shared = true;
+        auto result = kdalgorithms::filtered<std::vector>(
+            std::move(vec), [](const std::string &s) { return s.size() == 1; });
+        QCOMPARE(result, (std::vector<std::string>{"a", "c"}));
+        auto copy = kdalgorithms::copied<std::vector<std::string>>(std::move(vec));
+        QCOMPARE(copy, (std::vector<std::string>{"a", "bb", "c"}));
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec[0], std::string("a"));
+    }
+
+    { // zip, unzipped and multi_partitioned
+        SharedVector<std::string> vec{"a", "bb", "c"};
+        vec.shared = true;
+        auto zipped = kdalgorithms::zip(std::move(vec), std::vector<int>{1, 2, 3});
+        QCOMPARE(std::get<0>(zipped[1]), std::string("bb"));
+        auto parts = kdalgorithms::multi_partitioned(
+            std::move(vec), [](const std::string &s) { return s.size(); });
+        QCOMPARE(parts[1u], (SharedVector<std::string>{"a", "c"}));
+        std::vector<std::pair<std::size_t, std::string>> sunk;
+        kdalgorithms::multi_partitioned(
+            std::move(vec), [](const std::string &s) { return s.size(); },
+            kdalgorithms::to_sink(std::back_inserter(sunk)));
+        QCOMPARE(sunk.size(), 3u);
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec[1], std::string("bb"));
+
+        SharedVector<std::pair<std::string, int>> pairs{{"a", 1}, {"b", 2}};
+        pairs.shared = true;
+        auto columns = kdalgorithms::unzipped(std::move(pairs));
+        QCOMPARE(std::get<0>(columns), (std::vector<std::string>{"a", "b"}));
+        auto names = kdalgorithms::unzipped(std::move(pairs),
+                                            &std::pair<std::string, int>::first);
+        QCOMPARE(std::get<0>(names), (std::vector<std::string>{"a", "b"}));
+        QCOMPARE(pairs.detachCount, 0);
+        QCOMPARE(pairs[0].first, std::string("a"));
+    }
+
+    { // flat_transformed, the set algorithms, semi_joined and for_each
+        SharedVector<std::string> vec{"a", "b", "c"};
+        vec.shared = true;
+        auto twice = [](const std::string &s) { return std::vector<std::string>{s, s}; };
+        auto flat = kdalgorithms::flat_transformed(std::move(vec), twice);
+        QCOMPARE(flat.size(), 6u);
+        flat = kdalgorithms::flat_transformed(std::move(vec), twice,
+                                              kdalgorithms::flatten_reserve_exact);
+        QCOMPARE(flat.size(), 6u);
+        auto both = kdalgorithms::set_union(std::move(vec), SharedVector<std::string>{"d"});
+        QCOMPARE(both, (SharedVector<std::string>{"a", "b", "c", "d"}));
+        both = kdalgorithms::set_union(SharedVector<std::string>{"d"}, std::move(vec));
+        QCOMPARE(both.size(), 4u);
+        auto unordered =
+            kdalgorithms::set_union_unordered(std::move(vec), SharedVector<std::string>{"d"});
+        QCOMPARE(unordered.size(), 4u);
+        auto identity = [](const std::string &s) { return s; };
+        auto matched = kdalgorithms::semi_joined(std::move(vec), std::vector<std::string>{"b"},
+                                                 identity, identity);
+        QCOMPARE(matched, (SharedVector<std::string>{"b"}));
+        std::vector<std::string> visited;
+        kdalgorithms::for_each(std::move(vec), [&visited](std::string s) {
+            visited.push_back(std::move(s));
+        });
+        QCOMPARE(visited.size(), 3u);
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec[0], std::string("a"));
+    }
+
+    { // merged, the scans, grouped_adjacent and enumerate
+        SharedVector<std::string> vec{"a", "c", "e"};
+        vec.shared = true;
+        SharedVector<std::string> other{"b", "d"};
+        auto merged = kdalgorithms::merged(std::move(vec), std::move(other));
+        QCOMPARE(merged, (SharedVector<std::string>{"a", "b", "c", "d", "e"}));
+        QCOMPARE(other[0], std::string("b"));
+        std::vector<SharedVector<std::string>> sources{vec, {"b"}};
+        sources[0].shared = true;
+        merged = kdalgorithms::merged(std::move(sources));
+        QCOMPARE(merged, (SharedVector<std::string>{"a", "b", "c", "e"}));
+        QCOMPARE(sources[0].detachCount, 0);
+
+        auto sums = kdalgorithms::inclusive_scanned(std::move(vec));
+        QCOMPARE(sums, (SharedVector<std::string>{"a", "ac", "ace"}));
+        sums = kdalgorithms::exclusive_scanned(std::move(vec), std::plus<std::string>(),
+                                               std::string("-"));
+        QCOMPARE(sums, (SharedVector<std::string>{"-", "-a", "-ac"}));
+
+        auto groups = kdalgorithms::grouped_adjacent(
+            std::move(vec), [](const std::string &s) { return s == "a"; });
+        QCOMPARE(groups.size(), 2u);
+        QCOMPARE(groups[1].items, (SharedVector<std::string>{"c", "e"}));
+        QCOMPARE(vec.detachCount, 0);
+        QCOMPARE(vec[0], std::string("a"));
+
+        auto view = kdalgorithms::enumerate(std::move(vec));
+        QVERIFY((std::is_same<decltype((*view.begin()).second), const std::string &>::value));
+        QCOMPARE((*view.begin()).second, std::string("a"));
+    }
+
+    { // A Qt container, which shares its data with copy
+        QVector<QString> vec{"a", "b", "c"};
+        const auto copy = vec;
+        auto result = kdalgorithms::zip(std::move(vec), std::vector<int>{1, 2, 3});
+        QCOMPARE(std::get<0>(result[2]), QString("c"));
+        auto flat = kdalgorithms::flat_transformed(
+            std::move(vec), [](const QString &s) { return QVector<QString>{s, s}; });
+        QCOMPARE(flat.size(), 6);
+        QVERIFY(!vec.isDetached());
+        QCOMPARE(vec, copy);
+    }
+
+    { // Containers without isDetached never read their r-values as l-values, so items can be
+      // move-only
+        std::vector<std::unique_ptr<int>> pointers;
+        pointers.push_back(std::make_unique<int>(1));
+        auto result = kdalgorithms::filtered<std::list>(
+            std::move(pointers), [](const std::unique_ptr<int> &p) { return *p == 1; });
+        auto moved = kdalgorithms::transformed<std::vector>(
+            std::move(result), [](std::unique_ptr<int> p) { return p; });
+        QCOMPARE(*moved.front(), 1);
+    }
+}
+
 void TestAlgorithms::for_each()
 {
     { // simple lambda
@@ -2946,6 +4523,29 @@ void TestAlgorithms::multi_partitioned()
                                                       {"50-59", {{"Jesper", 52}, {"Kalle", 53}}}};
         QCOMPARE(result, expected);
     }
+
+    { // Runs of items with the same key are added to the partition without looking it up again
+        static int hashes = 0;
+        struct CountingHash
+        {
+            std::size_t operator()(int key) const
+            {
+                ++hashes;
+                return std::hash<int>()(key);
+            }
+        };
+        using Partitions = std::unordered_map<int, std::vector<int>, CountingHash>;
+        const std::vector<int> sortedInts{1, 1, 1, 2, 2, 3, 3, 3, 3};
+        auto result =
+            kdalgorithms::multi_partitioned<Partitions>(sortedInts, [](int i) { return i; });
+        QCOMPARE(hashes, 3);
+        QCOMPARE(result[3], (std::vector<int>{3, 3, 3, 3}));
+
+        auto unsorted = kdalgorithms::multi_partitioned<std::map<int, std::vector<int>>>(
+            std::vector<int>{3, 1, 3, 2, 1, 1}, [](int i) { return i; });
+        std::map<int, std::vector<int>> expected{{1, {1, 1, 1}}, {2, {2}}, {3, {3, 3}}};
+        QCOMPARE(unsorted, expected);
+    }
 }
 
 void TestAlgorithms::multi_partitioned_with_function_taking_a_value()
@@ -2965,6 +4565,187 @@ void TestAlgorithms::multi_partitioned_with_function_taking_a_value()
     QCOMPARE(result, expected);
 }
 
+void TestAlgorithms::groupAdjacent()
+{
+    std::vector<Person> people{
+        {"Jesper", 52}, {"Kalle", 52}, {"Ivan", 42}, {"Till", 44}, {"Nicolas", 44}, {"Bo", 52}};
+
+    { // view
+        std::vector<int> ages;
+        std::vector<QString> names;
+        for (const auto &group : kdalgorithms::group_adjacent(people, &Person::age)) {
+            ages.push_back(group.key);
+            names.push_back(kdalgorithms::accumulate(group.items, [](QString acc, const Person &p) {
+                return acc + p.name;
+            }));
+        }
+        QCOMPARE(ages, std::vector<int>({52, 42, 44, 52}));
+        QCOMPARE(names, std::vector<QString>({"JesperKalle", "Ivan", "TillNicolas", "Bo"}));
+    }
+
+    { // the items are views into the container
+        auto groups = kdalgorithms::group_adjacent(people, &Person::age);
+        QCOMPARE(groups.size(), 4u);
+        auto first = *groups.begin();
+        QCOMPARE(first.items.size(), 2u);
+        QCOMPARE(&first.items.front(), &people[0]);
+        QVERIFY(kdalgorithms::all_of(first.items, [](const Person &p) { return p.age == 52; }));
+    }
+
+    { // empty
+        std::vector<int> empty;
+        auto groups = kdalgorithms::group_adjacent(empty, [](int i) { return i / 10; });
+        QVERIFY(groups.empty());
+        QVERIFY(groups.begin() == groups.end());
+    }
+
+    { // std::list
+        std::list<int> list{1, 3, 2, 4, 6, 5};
+        std::vector<bool> keys;
+        auto isEven = [](int i) { return i % 2 == 0; };
+        for (const auto &group : kdalgorithms::group_adjacent(list, isEven))
+            keys.push_back(group.key);
+        QCOMPARE(keys, std::vector<bool>({false, true, false}));
+    }
+
+    { // materialized
+        auto result = kdalgorithms::grouped_adjacent(people, &Person::age);
+        QCOMPARE(result.size(), 4u);
+        QCOMPARE(result[0].key, 52);
+        QCOMPARE(result[0].items, std::vector<Person>({{"Jesper", 52}, {"Kalle", 52}}));
+        QCOMPARE(result[2].key, 44);
+        QCOMPARE(result[2].items, std::vector<Person>({{"Till", 44}, {"Nicolas", 44}}));
+        QCOMPARE(result[3].items, std::vector<Person>({{"Bo", 52}}));
+        QCOMPARE(result[0].items.capacity(), 2u);
+    }
+
+    { // materialized from an r-value moves the items
+        std::vector<std::unique_ptr<int>> pointers;
+        for (int i : {1, 1, 2})
+            pointers.push_back(std::make_unique<int>(i));
+        auto value = [](const std::unique_ptr<int> &p) { return *p; };
+        auto result = kdalgorithms::grouped_adjacent(std::move(pointers), value);
+        QCOMPARE(result.size(), 2u);
+        QCOMPARE(result[0].items.size(), 2u);
+        QCOMPARE(*result[1].items[0], 2);
+    }
+}
+
+void TestAlgorithms::chunkBy()
+{
+    std::vector<int> vec{1, 2, 3, 2, 3, 4, 1};
+    std::vector<std::vector<int>> chunks;
+    for (auto chunk : kdalgorithms::chunk_by(vec, [](int x, int y) { return x < y; }))
+        chunks.emplace_back(chunk.begin(), chunk.end());
+    QCOMPARE(chunks, std::vector<std::vector<int>>({{1, 2, 3}, {2, 3, 4}, {1}}));
+
+    auto view = kdalgorithms::chunk_by(vec, std::less<int>());
+    QCOMPARE(view.size(), 3u);
+
+    // The chunks can be given to the other algorithms
+    auto sums = kdalgorithms::transformed<std::vector>(
+        view, [](const auto &chunk) { return kdalgorithms::accumulate(chunk, std::plus<int>()); });
+    QCOMPARE(sums, std::vector<int>({6, 9, 1}));
+
+    std::vector<int> empty;
+    QCOMPARE(kdalgorithms::chunk_by(empty, std::less<int>()).size(), 0u);
+}
+
+void TestAlgorithms::chunked()
+{
+    std::vector<int> vec{1, 2, 3, 4, 5, 6, 7};
+
+    auto chunks = kdalgorithms::chunked(vec, 3);
+    QCOMPARE(chunks.size(), 3u);
+    QCOMPARE(&chunks[0].front(), &vec[0]); // no copies
+    QCOMPARE(chunks[2].size(), 1u);
+
+    auto sums = kdalgorithms::transformed<std::vector>(
+        chunks, [](const auto &chunk) {
+            return kdalgorithms::accumulate(chunk, std::plus<int>());
+        });
+    QCOMPARE(sums, std::vector<int>({6, 15, 7}));
+
+    // The items may be modified through the chunks
+    kdalgorithms::for_each(kdalgorithms::chunked(vec, 2), [](auto chunk) {
+        for (auto &item : chunk)
+            item *= 10;
+    });
+    QCOMPARE(vec, std::vector<int>({10, 20, 30, 40, 50, 60, 70}));
+
+    { // parallel algorithms
+        std::vector<int> large(1000);
+        std::iota(large.begin(), large.end(), 0);
+        auto batches = kdalgorithms::chunked(large, 64);
+        auto containsValue = [](int value) {
+            return [value](const auto &batch) { return kdalgorithms::contains(batch, value); };
+        };
+        QVERIFY(kdalgorithms::parallel_any_of(batches, containsValue(999)));
+        QVERIFY(!kdalgorithms::parallel_any_of(batches, containsValue(1000)));
+        auto it = kdalgorithms::parallel_find_if(batches, containsValue(500));
+        QVERIFY(it.has_result());
+        QCOMPARE(it.iterator - batches.begin(), 7);
+    }
+
+    { // empty and exact multiple
+        std::vector<int> empty;
+        QVERIFY(kdalgorithms::chunked(empty, 4).empty());
+        std::vector<int> four{1, 2, 3, 4};
+        QCOMPARE(kdalgorithms::chunked(four, 2).size(), 2u);
+        QCOMPARE(kdalgorithms::chunked(four, 8).size(), 1u);
+    }
+
+    { // A size of zero gives empty views
+        QVERIFY(kdalgorithms::chunked(vec, 0).empty());
+        QVERIFY(kdalgorithms::windowed(vec, 0).empty());
+        QVERIFY(kdalgorithms::strided(vec, 0).empty());
+    }
+}
+
+void TestAlgorithms::windowed()
+{
+    std::vector<int> vec{1, 2, 3, 4, 5};
+    auto windows = kdalgorithms::windowed(vec, 3);
+    QCOMPARE(windows.size(), 3u);
+
+    auto sums = kdalgorithms::transformed<std::vector>(
+        windows, [](const auto &window) {
+            return kdalgorithms::accumulate(window, std::plus<int>());
+        });
+    QCOMPARE(sums, std::vector<int>({6, 9, 12}));
+
+    QCOMPARE(kdalgorithms::windowed(vec, 5).size(), 1u);
+    QVERIFY(kdalgorithms::windowed(vec, 6).empty());
+
+    // Iterators are random access
+    auto it = windows.end();
+    --it;
+    QCOMPARE((*it).front(), 3);
+    QCOMPARE(it - windows.begin(), 2);
+    QCOMPARE(windows.begin()[1].front(), 2);
+}
+
+void TestAlgorithms::strided()
+{
+    std::vector<int> vec{0, 1, 2, 3, 4, 5, 6};
+    auto everyThird = kdalgorithms::strided(vec, 3);
+    QCOMPARE(everyThird.size(), 3u);
+    QCOMPARE(kdalgorithms::transformed<std::vector>(everyThird, [](int i) { return i; }),
+             std::vector<int>({0, 3, 6}));
+
+    for (int &i : kdalgorithms::strided(vec, 2))
+        i = -i;
+    QCOMPARE(vec, std::vector<int>({0, 1, -2, 3, -4, 5, -6}));
+
+    QVERIFY(kdalgorithms::parallel_any_of(everyThird, [](int i) { return i == -6; }));
+    QVERIFY(!kdalgorithms::parallel_any_of(everyThird, [](int i) { return i == 5; }));
+
+    // Indexing the view gives references just like the iterators
+    everyThird[1] = 42;
+    QCOMPARE(vec[3], 42);
+    QCOMPARE(&everyThird[2], &*(everyThird.begin() + 2));
+}
+
 void TestAlgorithms::sub_range()
 {
 #if __cplusplus >= 202302L || (!defined(__APPLE__) && __cplusplus >= 202002L)
@@ -3068,6 +4849,242 @@ void TestAlgorithms::product()
     }
 }
 
+void TestAlgorithms::joined()
+{
+    struct Order
+    {
+        int id;
+        int customer;
+    };
+    using Result = std::pair<int, QString>;
+    auto combine = [](const Order &order, const Person &person) {
+        return Result{order.id, person.name};
+    };
+    const std::vector<Person> customers{{"Jesper", 0}, {"Kalle", 1}, {"Ida", 2}, {"Anna", 3}};
+    auto age = [](const Person &person) { return person.age; };
+
+    { // Unsorted, hash join in the order of the left side, whichever side is smaller
+        std::vector<Order> orders{{10, 2}, {11, 0}, {12, 2}, {13, 7}, {14, 1}};
+        auto result = kdalgorithms::joined(orders, customers, &Order::customer, age, combine);
+        std::vector<Result> expected{{10, "Ida"}, {11, "Jesper"}, {12, "Ida"}, {14, "Kalle"}};
+        QCOMPARE(result, expected);
+
+        result = kdalgorithms::joined(std::vector<Order>{{15, 3}, {16, 1}}, customers,
+                                      &Order::customer, age, combine);
+        expected = {{15, "Anna"}, {16, "Kalle"}};
+        QCOMPARE(result, expected);
+
+        result = kdalgorithms::joined(std::vector<Order>{{20, 3}}, customers, &Order::customer,
+                                      age, combine);
+        expected = {{20, "Anna"}};
+        QCOMPARE(result, expected);
+    }
+
+    { // Both sides sorted, merge join in the order of the left side
+        std::vector<Order> orders{{10, 0}, {11, 0}, {12, 2}, {13, 2}, {14, 3}, {15, 5}};
+        auto result = kdalgorithms::joined(orders, customers, &Order::customer, age, combine);
+        std::vector<Result> expected{
+            {10, "Jesper"}, {11, "Jesper"}, {12, "Ida"}, {13, "Ida"}, {14, "Anna"}};
+        QCOMPARE(result, expected);
+    }
+
+    { // Duplicate keys on both sides
+        std::vector<int> left{3, 1, 2, 1};
+        std::vector<int> right{1, 5, 1, 3};
+        auto identity = [](int i) { return i; };
+        auto result = kdalgorithms::joined(left, right, identity, identity,
+                                           [](int x, int y) { return std::make_pair(x, y); });
+        std::vector<std::pair<int, int>> expected{{1, 1}, {1, 1}, {1, 1}, {1, 1}, {3, 3}};
+        QCOMPARE(kdalgorithms::sorted(result), expected);
+    }
+
+    { // Keys without std::hash are joined by sorting
+        std::vector<std::pair<int, int>> left{{2, 1}, {1, 1}, {3, 3}};
+        std::vector<std::pair<int, int>> right{{3, 3}, {1, 1}, {1, 2}};
+        auto identity = [](const std::pair<int, int> &pair) { return pair; };
+        auto result = kdalgorithms::joined(
+            left, right, identity, identity,
+            [](const std::pair<int, int> &x, const std::pair<int, int> &) { return x.first; });
+        std::vector<int> expected{1, 3};
+        QCOMPARE(result, expected);
+    }
+
+    { // Keys with neither std::hash nor operator<
+        auto result = kdalgorithms::joined<std::deque>(
+            structVec, getStruct(), [](const Struct &s) { return Struct{s.key, 0}; },
+            [](const Struct &s) { return Struct{s.value, 0}; },
+            [](const Struct &x, const Struct &y) { return x.value * 10 + y.key; });
+        std::deque<int> expected{42, 31, 23, 14};
+        QCOMPARE(result, expected);
+    }
+}
+
+void TestAlgorithms::left_joined()
+{
+    struct Order
+    {
+        int id;
+        int customer;
+    };
+    const std::vector<Person> customers{{"Jesper", 0}, {"Kalle", 1}, {"Ida", 2}};
+    auto combine = [](const Order &order, const Person *person) {
+        return std::make_pair(order.id, person ? person->name : QString("-"));
+    };
+    using Result = std::pair<int, QString>;
+
+    { // Unsorted
+        std::vector<Order> orders{{10, 2}, {11, 7}, {12, 2}, {13, 0}, {14, 9}};
+        auto result =
+            kdalgorithms::left_joined(orders, customers, &Order::customer, &Person::age, combine);
+        std::vector<Result> expected{
+            {10, "Ida"}, {11, "-"}, {12, "Ida"}, {13, "Jesper"}, {14, "-"}};
+        QCOMPARE(result, expected);
+    }
+
+    { // Sorted
+        std::vector<Order> orders{{10, -1}, {11, 1}, {12, 1}, {13, 5}};
+        auto result =
+            kdalgorithms::left_joined(orders, customers, &Order::customer, &Person::age, combine);
+        std::vector<Result> expected{{10, "-"}, {11, "Kalle"}, {12, "Kalle"}, {13, "-"}};
+        QCOMPARE(result, expected);
+    }
+
+    { // Empty right side
+        std::vector<Order> orders{{10, 1}};
+        auto result = kdalgorithms::left_joined(orders, std::vector<Person>{}, &Order::customer,
+                                                &Person::age, combine);
+        std::vector<Result> expected{{10, "-"}};
+        QCOMPARE(result, expected);
+    }
+}
+
+void TestAlgorithms::semi_anti_joined()
+{
+    const std::vector<int> blocked{4, 2};
+    auto key = [](const Struct &s) { return s.key; };
+    auto identity = [](int i) { return i; };
+
+    {
+        auto result = kdalgorithms::semi_joined(unsortedStructVec, blocked, key, identity);
+        std::vector<Struct> expected{{2, 4}, {4, 2}};
+        QCOMPARE(result, expected);
+
+        result = kdalgorithms::anti_joined(unsortedStructVec, blocked, key, identity);
+        expected = {{1, 3}, {3, 1}, {5, 4}};
+        QCOMPARE(result, expected);
+    }
+
+    { // Member variable and r-value
+        auto result = kdalgorithms::semi_joined(getStruct(), blocked, &Struct::key, identity);
+        std::vector<Struct> expected{{2, 1}, {4, 4}};
+        QCOMPARE(result, expected);
+    }
+
+    { // r-values items are moved
+        std::vector<CopyObserver> vec{1, 2, 3, 4};
+        CopyObserver::reset();
+        auto result = kdalgorithms::anti_joined(std::move(vec), blocked, &CopyObserver::value,
+                                                identity);
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result.size(), 2);
+        QCOMPARE(result[1].value, 3);
+    }
+}
+
+void TestAlgorithms::set_algebra()
+{
+    const std::vector<int> v1{1, 2, 2, 2, 4, 6, 8};
+    const std::vector<int> v2{2, 2, 3, 4, 9};
+
+    {
+        std::vector<int> expected{1, 2, 2, 2, 3, 4, 6, 8, 9};
+        QCOMPARE(kdalgorithms::set_union(v1, v2), expected);
+        expected = {2, 2, 4};
+        QCOMPARE(kdalgorithms::set_intersection(v1, v2), expected);
+        expected = {1, 2, 6, 8};
+        QCOMPARE(kdalgorithms::set_difference(v1, v2), expected);
+        expected = {1, 2, 3, 6, 8, 9};
+        QCOMPARE(kdalgorithms::set_symmetric_difference(v1, v2), expected);
+        QCOMPARE(kdalgorithms::set_union(v1, emptyIntVector), v1);
+        QCOMPARE(kdalgorithms::set_intersection(emptyIntVector, v1), emptyIntVector);
+    }
+
+    { // Very different sizes, which makes the algorithms gallop
+        std::vector<int> large(10000);
+        std::iota(large.begin(), large.end(), 0);
+        std::vector<int> small{-5, 3, 3, 700, 701, 5000, 9999, 12000};
+        auto expectedFor = [&](auto algorithm, const auto &x, const auto &y) {
+            std::vector<int> result;
+            algorithm(x.cbegin(), x.cend(), y.cbegin(), y.cend(), std::back_inserter(result));
+            return result;
+        };
+        auto stdUnion = [](auto... args) { return std::set_union(args...); };
+        auto stdIntersection = [](auto... args) { return std::set_intersection(args...); };
+        auto stdDifference = [](auto... args) { return std::set_difference(args...); };
+        auto stdSymmetricDifference = [](auto... args) {
+            return std::set_symmetric_difference(args...);
+        };
+        for (int i = 0; i < 2; ++i) {
+            const auto &x = i == 0 ? large : small;
+            const auto &y = i == 0 ? small : large;
+            QCOMPARE(kdalgorithms::set_union(x, y), expectedFor(stdUnion, x, y));
+            QCOMPARE(kdalgorithms::set_intersection(x, y), expectedFor(stdIntersection, x, y));
+            QCOMPARE(kdalgorithms::set_difference(x, y), expectedFor(stdDifference, x, y));
+            QCOMPARE(kdalgorithms::set_symmetric_difference(x, y),
+                     expectedFor(stdSymmetricDifference, x, y));
+        }
+    }
+
+    { // Custom compare and result container
+        std::vector<int> x{9, 7, 5, 3};
+        std::list<int> y{8, 7, 3, 2};
+        auto result = kdalgorithms::set_intersection<QVector>(x, y, std::greater<int>());
+        QVector<int> expected{7, 3};
+        QCOMPARE(result, expected);
+    }
+
+    { // Sets
+        std::set<int> x{1, 3, 5};
+        std::set<int> y{3, 4};
+        std::set<int> expected{1, 3, 4, 5};
+        QCOMPARE(kdalgorithms::set_union(x, y), expected);
+        expected = {1, 5};
+        QCOMPARE(kdalgorithms::set_difference(x, y), expected);
+    }
+
+    { // r-values are moved from
+        std::vector<CopyObserver> x{1, 3, 5};
+        std::vector<CopyObserver> y{2, 3};
+        CopyObserver::reset();
+        auto result = kdalgorithms::set_union(std::move(x), std::move(y));
+        QCOMPARE(CopyObserver::copies, 0);
+        QCOMPARE(result.size(), 4);
+    }
+}
+
+void TestAlgorithms::set_algebra_unordered()
+{
+    const std::vector<int> v1{8, 2, 6, 2, 1, 2, 4};
+    const std::vector<int> v2{9, 2, 4, 3, 2};
+
+    std::vector<int> expected{8, 2, 6, 2, 1, 2, 4, 9, 3};
+    QCOMPARE(kdalgorithms::set_union_unordered(v1, v2), expected);
+    expected = {2, 2, 4};
+    QCOMPARE(kdalgorithms::set_intersection_unordered(v1, v2), expected);
+    expected = {8, 6, 1, 2};
+    QCOMPARE(kdalgorithms::set_difference_unordered(v1, v2), expected);
+    expected = {8, 6, 1, 2, 9, 3};
+    QCOMPARE(kdalgorithms::set_symmetric_difference_unordered(v1, v2), expected);
+
+    { // r-values
+        std::vector<std::string> x{"abc", "def", "hij"};
+        auto result =
+            kdalgorithms::set_difference_unordered(std::move(x), std::vector<std::string>{"def"});
+        std::vector<std::string> expected{"abc", "hij"};
+        QCOMPARE(result, expected);
+    }
+}
+
 QTEST_MAIN(TestAlgorithms)
 
 #include "tst_kdalgorithms.moc"